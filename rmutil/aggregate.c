@@ -0,0 +1,358 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "aggregate.h"
+#include "simd.h"
+
+#ifdef RMUTIL_X86_SIMD
+#include <immintrin.h>
+#endif
+
+/* Return a pointer to element first of v, and set *n to the size of [first,last) clamped to the vector's size */
+static inline const void *__agg_range(Vector *v, size_t first, size_t last, size_t *n) {
+    if (last > v->top)
+        last = v->top;
+    *n = first < last ? last - first : 0;
+    return v->data + first * v->elemSize;
+}
+
+/* Scalar kernels for a given element type T, accumulated as A, with function names suffixed by S. Integers are
+ * accumulated as unsigned so that overflow wraps around instead of being undefined */
+#define AGG_SCALAR_KERNELS(T, A, S)                                                                                  \
+    static T __sum_scalar_##S(const T *p, size_t n) {                                                                \
+        A s0 = 0, s1 = 0, s2 = 0, s3 = 0;                                                                            \
+        size_t i = 0;                                                                                                \
+        for (; i + 4 <= n; i += 4) {                                                                                 \
+            s0 += p[i];                                                                                              \
+            s1 += p[i + 1];                                                                                          \
+            s2 += p[i + 2];                                                                                          \
+            s3 += p[i + 3];                                                                                          \
+        }                                                                                                            \
+        for (; i < n; i++)                                                                                           \
+            s0 += p[i];                                                                                              \
+        return (T)((s0 + s1) + (s2 + s3));                                                                           \
+    }                                                                                                                \
+                                                                                                                     \
+    /* n must not be 0 */                                                                                            \
+    static T __min_scalar_##S(const T *p, size_t n) {                                                                \
+        T m0 = p[0], m1 = p[0], m2 = p[0], m3 = p[0];                                                                \
+        size_t i = 0;                                                                                                \
+        for (; i + 4 <= n; i += 4) {                                                                                 \
+            m0 = p[i] < m0 ? p[i] : m0;                                                                              \
+            m1 = p[i + 1] < m1 ? p[i + 1] : m1;                                                                      \
+            m2 = p[i + 2] < m2 ? p[i + 2] : m2;                                                                      \
+            m3 = p[i + 3] < m3 ? p[i + 3] : m3;                                                                      \
+        }                                                                                                            \
+        for (; i < n; i++)                                                                                           \
+            m0 = p[i] < m0 ? p[i] : m0;                                                                              \
+        m0 = m1 < m0 ? m1 : m0;                                                                                      \
+        m2 = m3 < m2 ? m3 : m2;                                                                                      \
+        return m2 < m0 ? m2 : m0;                                                                                    \
+    }                                                                                                                \
+                                                                                                                     \
+    /* n must not be 0 */                                                                                            \
+    static T __max_scalar_##S(const T *p, size_t n) {                                                                \
+        T m0 = p[0], m1 = p[0], m2 = p[0], m3 = p[0];                                                                \
+        size_t i = 0;                                                                                                \
+        for (; i + 4 <= n; i += 4) {                                                                                 \
+            m0 = p[i] > m0 ? p[i] : m0;                                                                              \
+            m1 = p[i + 1] > m1 ? p[i + 1] : m1;                                                                      \
+            m2 = p[i + 2] > m2 ? p[i + 2] : m2;                                                                      \
+            m3 = p[i + 3] > m3 ? p[i + 3] : m3;                                                                      \
+        }                                                                                                            \
+        for (; i < n; i++)                                                                                           \
+            m0 = p[i] > m0 ? p[i] : m0;                                                                              \
+        m0 = m1 > m0 ? m1 : m0;                                                                                      \
+        m2 = m3 > m2 ? m3 : m2;                                                                                      \
+        return m2 > m0 ? m2 : m0;                                                                                    \
+    }
+
+AGG_SCALAR_KERNELS(int64_t, uint64_t, i64)
+AGG_SCALAR_KERNELS(double, double, double)
+
+#ifdef RMUTIL_X86_SIMD
+
+RMUTIL_TARGET("avx2")
+static int64_t __sum_avx2_i64(const int64_t *p, size_t n) {
+    __m256i s0 = _mm256_setzero_si256(), s1 = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        s0 = _mm256_add_epi64(s0, _mm256_loadu_si256((const __m256i *)(p + i)));
+        s1 = _mm256_add_epi64(s1, _mm256_loadu_si256((const __m256i *)(p + i + 4)));
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i *)lanes, _mm256_add_epi64(s0, s1));
+    uint64_t s = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; i < n; i++)
+        s += p[i];
+    return (int64_t)s;
+}
+
+// four accumulators hide the latency of the floating point adds
+RMUTIL_TARGET("avx2")
+static double __sum_avx2_double(const double *p, size_t n) {
+    __m256d s0 = _mm256_setzero_pd(), s1 = s0, s2 = s0, s3 = s0;
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        s0 = _mm256_add_pd(s0, _mm256_loadu_pd(p + i));
+        s1 = _mm256_add_pd(s1, _mm256_loadu_pd(p + i + 4));
+        s2 = _mm256_add_pd(s2, _mm256_loadu_pd(p + i + 8));
+        s3 = _mm256_add_pd(s3, _mm256_loadu_pd(p + i + 12));
+    }
+    for (; i + 4 <= n; i += 4)
+        s0 = _mm256_add_pd(s0, _mm256_loadu_pd(p + i));
+    double lanes[4];
+    _mm256_storeu_pd(lanes, _mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3)));
+    double s = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; i < n; i++)
+        s += p[i];
+    return s;
+}
+
+// there is no 64 bit integer min/max before AVX-512, so select with a compare mask
+RMUTIL_TARGET("avx2")
+static int64_t __min_avx2_i64(const int64_t *p, size_t n) {
+    __m256i m0 = _mm256_set1_epi64x(p[0]), m1 = m0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x0 = _mm256_loadu_si256((const __m256i *)(p + i));
+        __m256i x1 = _mm256_loadu_si256((const __m256i *)(p + i + 4));
+        m0 = _mm256_blendv_epi8(m0, x0, _mm256_cmpgt_epi64(m0, x0));
+        m1 = _mm256_blendv_epi8(m1, x1, _mm256_cmpgt_epi64(m1, x1));
+    }
+    m0 = _mm256_blendv_epi8(m0, m1, _mm256_cmpgt_epi64(m0, m1));
+    int64_t lanes[4];
+    _mm256_storeu_si256((__m256i *)lanes, m0);
+    int64_t m = __min_scalar_i64(lanes, 4);
+    return i < n ? __min_scalar_i64((int64_t[]){m, __min_scalar_i64(p + i, n - i)}, 2) : m;
+}
+
+RMUTIL_TARGET("avx2")
+static int64_t __max_avx2_i64(const int64_t *p, size_t n) {
+    __m256i m0 = _mm256_set1_epi64x(p[0]), m1 = m0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x0 = _mm256_loadu_si256((const __m256i *)(p + i));
+        __m256i x1 = _mm256_loadu_si256((const __m256i *)(p + i + 4));
+        m0 = _mm256_blendv_epi8(m0, x0, _mm256_cmpgt_epi64(x0, m0));
+        m1 = _mm256_blendv_epi8(m1, x1, _mm256_cmpgt_epi64(x1, m1));
+    }
+    m0 = _mm256_blendv_epi8(m0, m1, _mm256_cmpgt_epi64(m1, m0));
+    int64_t lanes[4];
+    _mm256_storeu_si256((__m256i *)lanes, m0);
+    int64_t m = __max_scalar_i64(lanes, 4);
+    return i < n ? __max_scalar_i64((int64_t[]){m, __max_scalar_i64(p + i, n - i)}, 2) : m;
+}
+
+RMUTIL_TARGET("avx2")
+static double __min_avx2_double(const double *p, size_t n) {
+    __m256d m0 = _mm256_set1_pd(p[0]), m1 = m0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        m0 = _mm256_min_pd(m0, _mm256_loadu_pd(p + i));
+        m1 = _mm256_min_pd(m1, _mm256_loadu_pd(p + i + 4));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, _mm256_min_pd(m0, m1));
+    double m = __min_scalar_double(lanes, 4);
+    return i < n ? __min_scalar_double((double[]){m, __min_scalar_double(p + i, n - i)}, 2) : m;
+}
+
+RMUTIL_TARGET("avx2")
+static double __max_avx2_double(const double *p, size_t n) {
+    __m256d m0 = _mm256_set1_pd(p[0]), m1 = m0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        m0 = _mm256_max_pd(m0, _mm256_loadu_pd(p + i));
+        m1 = _mm256_max_pd(m1, _mm256_loadu_pd(p + i + 4));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, _mm256_max_pd(m0, m1));
+    double m = __max_scalar_double(lanes, 4);
+    return i < n ? __max_scalar_double((double[]){m, __max_scalar_double(p + i, n - i)}, 2) : m;
+}
+
+#endif // RMUTIL_X86_SIMD
+
+#ifdef RMUTIL_X86_SIMD
+#define AGG_HAVE_AVX2() (RMUtil_CPUFeatures() & RMUTIL_CPU_AVX2)
+#else
+#define AGG_HAVE_AVX2() 0
+#define __sum_avx2_i64 __sum_scalar_i64
+#define __sum_avx2_double __sum_scalar_double
+#define __min_avx2_i64 __min_scalar_i64
+#define __max_avx2_i64 __max_scalar_i64
+#define __min_avx2_double __min_scalar_double
+#define __max_avx2_double __max_scalar_double
+#endif
+
+/* Public reductions for element type T, with kernels suffixed by S and functions suffixed by N */
+#define AGG_REDUCTIONS(T, S, N)                                                                                      \
+    T Vector_Sum##N(Vector *v, size_t first, size_t last) {                                                          \
+        size_t n;                                                                                                    \
+        const T *p = __agg_range(v, first, last, &n);                                                                \
+        return AGG_HAVE_AVX2() ? __sum_avx2_##S(p, n) : __sum_scalar_##S(p, n);                                      \
+    }                                                                                                                \
+                                                                                                                     \
+    int Vector_Min##N(Vector *v, size_t first, size_t last, T *min) {                                                \
+        size_t n;                                                                                                    \
+        const T *p = __agg_range(v, first, last, &n);                                                                \
+        if (!n)                                                                                                      \
+            return 0;                                                                                                \
+        *min = AGG_HAVE_AVX2() ? __min_avx2_##S(p, n) : __min_scalar_##S(p, n);                                      \
+        return 1;                                                                                                    \
+    }                                                                                                                \
+                                                                                                                     \
+    int Vector_Max##N(Vector *v, size_t first, size_t last, T *max) {                                                \
+        size_t n;                                                                                                    \
+        const T *p = __agg_range(v, first, last, &n);                                                                \
+        if (!n)                                                                                                      \
+            return 0;                                                                                                \
+        *max = AGG_HAVE_AVX2() ? __max_avx2_##S(p, n) : __max_scalar_##S(p, n);                                      \
+        return 1;                                                                                                    \
+    }
+
+AGG_REDUCTIONS(int64_t, i64, I64)
+AGG_REDUCTIONS(double, double, Double)
+
+/* Prepare out to receive n results, returning a pointer to its data */
+static void *__agg_output(Vector *out, size_t n) {
+    Vector_Reserve(out, n);
+    out->top = n;
+    return out->data;
+}
+
+void Vector_PrefixSumI64(Vector *src, Vector *out) {
+    size_t n = src->top;
+    const int64_t *p = (const int64_t *)src->data;
+    int64_t *o = __agg_output(out, n);
+    uint64_t s = 0;
+    for (size_t i = 0; i < n; i++) {
+        s += p[i];
+        o[i] = (int64_t)s;
+    }
+}
+
+void Vector_PrefixSumDouble(Vector *src, Vector *out) {
+    size_t n = src->top;
+    const double *p = (const double *)src->data;
+    double *o = __agg_output(out, n);
+    double s = 0;
+    for (size_t i = 0; i < n; i++) {
+        s += p[i];
+        o[i] = s;
+    }
+}
+
+/* Sliding min/max for element type T. BETTER(a, b) is true if a should be kept over b.
+ * The deque is a ring buffer of the indices of the window that may still become its extremum, with their values in
+ * strictly BETTER order from the front. The front is the extremum of the current window; each new sample evicts the
+ * candidates it beats from the back, and the front is dropped once it leaves the window. Every index is pushed and
+ * popped at most once, and the deque never holds more than w indices. */
+#define AGG_SLIDING_EXTREMUM(T, N, NAME, BETTER)                                                                     \
+    size_t Vector_Sliding##NAME##N(Vector *src, size_t w, Vector *out) {                                             \
+        size_t n = src->top;                                                                                         \
+        out->top = 0;                                                                                                \
+        if (w == 0 || w > n)                                                                                         \
+            return 0;                                                                                                \
+        const T *p = (const T *)src->data;                                                                           \
+        size_t *dq = malloc(w * sizeof(size_t));                                                                     \
+        if (!dq)                                                                                                     \
+            return 0;                                                                                                \
+        T *o = __agg_output(out, n - w + 1);                                                                         \
+        size_t head = 0, count = 0;                                                                                  \
+        for (size_t i = 0; i < n; i++) {                                                                             \
+            if (count && dq[head] + w <= i) {                                                                        \
+                head = head + 1 == w ? 0 : head + 1;                                                                 \
+                count--;                                                                                             \
+            }                                                                                                        \
+            while (count) {                                                                                          \
+                size_t back = head + count - 1;                                                                      \
+                if (back >= w)                                                                                       \
+                    back -= w;                                                                                       \
+                if (BETTER(p[dq[back]], p[i]))                                                                       \
+                    break;                                                                                           \
+                count--;                                                                                             \
+            }                                                                                                        \
+            size_t tail = head + count;                                                                              \
+            dq[tail >= w ? tail - w : tail] = i;                                                                     \
+            count++;                                                                                                 \
+            if (i + 1 >= w)                                                                                          \
+                o[i + 1 - w] = p[dq[head]];                                                                          \
+        }                                                                                                            \
+        free(dq);                                                                                                    \
+        return out->top;                                                                                             \
+    }
+
+#define AGG_LESS(a, b) ((a) < (b))
+#define AGG_GREATER(a, b) ((a) > (b))
+
+AGG_SLIDING_EXTREMUM(int64_t, I64, Min, AGG_LESS)
+AGG_SLIDING_EXTREMUM(int64_t, I64, Max, AGG_GREATER)
+AGG_SLIDING_EXTREMUM(double, Double, Min, AGG_LESS)
+AGG_SLIDING_EXTREMUM(double, Double, Max, AGG_GREATER)
+
+size_t Vector_SlidingSumI64(Vector *src, size_t w, Vector *out) {
+    size_t n = src->top;
+    out->top = 0;
+    if (w == 0 || w > n)
+        return 0;
+    const int64_t *p = (const int64_t *)src->data;
+    int64_t *o = __agg_output(out, n - w + 1);
+    uint64_t s = 0;
+    for (size_t i = 0; i < w; i++)
+        s += p[i];
+    o[0] = (int64_t)s;
+    for (size_t i = w; i < n; i++) {
+        s += p[i] - (uint64_t)p[i - w];
+        o[i + 1 - w] = (int64_t)s;
+    }
+    return out->top;
+}
+
+/* Add x to the compensated sum (*s, *c), keeping the low order bits lost by the addition in c (Neumaier) */
+static inline void __agg_add(double *s, double *c, double x) {
+    double t = *s + x;
+    *c += fabs(*s) >= fabs(x) ? (*s - t) + x : (x - t) + *s;
+    *s = t;
+}
+
+// A plain running sum would accumulate the rounding error of every add and subtract over the whole vector
+size_t Vector_SlidingSumDouble(Vector *src, size_t w, Vector *out) {
+    size_t n = src->top;
+    out->top = 0;
+    if (w == 0 || w > n)
+        return 0;
+    const double *p = (const double *)src->data;
+    double *o = __agg_output(out, n - w + 1);
+    double s = 0, c = 0;
+    for (size_t i = 0; i < w; i++)
+        __agg_add(&s, &c, p[i]);
+    o[0] = s + c;
+    for (size_t i = w; i < n; i++) {
+        __agg_add(&s, &c, p[i]);
+        __agg_add(&s, &c, -p[i - w]);
+        o[i + 1 - w] = s + c;
+    }
+    return out->top;
+}
+
+size_t Vector_SlidingMeanI64(Vector *src, size_t w, Vector *out) {
+    size_t n = Vector_SlidingSumI64(src, w, out);
+    // int64_t and double have the same size, so the sums are converted in place
+    for (size_t i = 0; i < n; i++) {
+        int64_t s;
+        memcpy(&s, out->data + i * sizeof(s), sizeof(s));
+        double m = (double)s / w;
+        memcpy(out->data + i * sizeof(m), &m, sizeof(m));
+    }
+    return n;
+}
+
+size_t Vector_SlidingMeanDouble(Vector *src, size_t w, Vector *out) {
+    size_t n = Vector_SlidingSumDouble(src, w, out);
+    double *o = (double *)out->data;
+    for (size_t i = 0; i < n; i++)
+        o[i] /= w;
+    return n;
+}
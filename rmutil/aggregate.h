@@ -0,0 +1,48 @@
+#ifndef __AGGREGATE_H__
+#define __AGGREGATE_H__
+
+#include <stdint.h>
+#include "vector.h"
+
+/* Aggregation kernels over numeric vectors
+ * These work on vectors of int64_t or double samples, as the suffix of each function says.
+ */
+
+/* Reductions
+ * Sum, minimum and maximum of the range [first,last). They use AVX2 when the CPU supports it (see simd.h), and
+ * unrolled scalar loops otherwise.
+ * Min and Max return 0 if the range is empty, 1 otherwise. Sums of doubles are computed in several lanes at once, so
+ * they may round differently than a sequential sum. NaNs give unspecified results.
+ */
+int64_t Vector_SumI64(Vector *v, size_t first, size_t last);
+double Vector_SumDouble(Vector *v, size_t first, size_t last);
+
+int Vector_MinI64(Vector *v, size_t first, size_t last, int64_t *min);
+int Vector_MaxI64(Vector *v, size_t first, size_t last, int64_t *max);
+int Vector_MinDouble(Vector *v, size_t first, size_t last, double *min);
+int Vector_MaxDouble(Vector *v, size_t first, size_t last, double *max);
+
+/* Prefix sums
+ * Replace the contents of out with the inclusive prefix sums of src: out[i] = src[0] + ... + src[i]. The sum of any
+ * range [i,j) is then out[j-1] - out[i-1]. out must have the same element type as src.
+ */
+void Vector_PrefixSumI64(Vector *src, Vector *out);
+void Vector_PrefixSumDouble(Vector *src, Vector *out);
+
+/* Sliding windows
+ * Replace the contents of out with the aggregate of every window of w consecutive samples of src, so that out[i]
+ * covers src[i, i+w). Each function takes O(n) regardless of w: min and max keep a monotonic deque of candidates,
+ * and sums are kept as running sums. Returns the number of windows, which is 0 if w is 0 or larger than src.
+ * out holds the same type as src, except for the means which are always doubles.
+ */
+size_t Vector_SlidingMinI64(Vector *src, size_t w, Vector *out);
+size_t Vector_SlidingMaxI64(Vector *src, size_t w, Vector *out);
+size_t Vector_SlidingMinDouble(Vector *src, size_t w, Vector *out);
+size_t Vector_SlidingMaxDouble(Vector *src, size_t w, Vector *out);
+
+size_t Vector_SlidingSumI64(Vector *src, size_t w, Vector *out);
+size_t Vector_SlidingSumDouble(Vector *src, size_t w, Vector *out);
+size_t Vector_SlidingMeanI64(Vector *src, size_t w, Vector *out);
+size_t Vector_SlidingMeanDouble(Vector *src, size_t w, Vector *out);
+
+#endif //__AGGREGATE_H__
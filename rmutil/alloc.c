@@ -13,6 +13,20 @@ char *rmalloc_strndup(const char *s, size_t n) {
   return ret;
 }
 
+static void *rmSDSMalloc(void *ctx, size_t size) {
+  return RedisModule_Alloc(size);
+}
+
+static void *rmSDSRealloc(void *ctx, void *ptr, size_t size) {
+  return RedisModule_Realloc(ptr, size);
+}
+
+static void rmSDSFree(void *ctx, void *ptr) {
+  RedisModule_Free(ptr);
+}
+
+const sdsAllocator RMUtil_SDSAllocator = {rmSDSMalloc, rmSDSRealloc, rmSDSFree, NULL};
+
 /*
  * Re-patching RedisModule_Alloc and friends to the original malloc functions
  *
@@ -18,9 +18,18 @@
 
 #include <stdlib.h>
 #include "../redismodule.h"
+#include "sdsalloc.h"
 
 char *rmalloc_strndup(const char *s, size_t n);
 
+/* An SDS allocator using RedisModule_Alloc and friends, so that Redis
+ * accounts for the strings built with SDS. Select it when loading the
+ * module, before creating any string:
+ *
+ *   sdsSetAllocator(&RMUtil_SDSAllocator);
+ */
+extern const sdsAllocator RMUtil_SDSAllocator;
+
 #ifdef REDIS_MODULE_TARGET /* Set this when compiling your code as a module */
 
 #define malloc(size) RedisModule_Alloc(size)
@@ -0,0 +1,113 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include "bytes.h"
+#include "simd.h"
+
+/* Benchmark tokenizing and case conversion of a 1MB buffer with the scalar, SSE2 and AVX2 kernels, against byte by
+ * byte loops like the ones strings.c used before. The scalar level of the splits is the memchr based search sds used
+ * before, and single byte separators use memchr at every level */
+
+#define BENCH_SIZE (1 << 20)
+#define BENCH_ROUNDS 50
+
+static double now_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static size_t count_naive(const char *p, size_t n, const char *sep, size_t seplen) {
+    size_t count = 0;
+    for (size_t j = 0; j + seplen <= n; j++) {
+        if ((seplen == 1 && p[j] == sep[0]) || memcmp(p + j, sep, seplen) == 0) {
+            count++;
+            j += seplen - 1;
+        }
+    }
+    return count;
+}
+
+static size_t count_kernel(const char *p, size_t n, const char *sep, size_t seplen) {
+    size_t count = 0;
+    const char *end = p + n;
+    while ((p = RMUtil_FindSep(p, end - p, sep, seplen))) {
+        count++;
+        p += seplen;
+    }
+    return count;
+}
+
+static void lower_naive(char *p, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        p[i] = tolower(p[i]);
+    }
+}
+
+static void report(const char *name, const char *level, double start) {
+    double ms = (now_ms() - start) / BENCH_ROUNDS;
+    printf("%-20s %-7s %8.3f ms %8.2f GB/s\n", name, level, ms, BENCH_SIZE / ms / 1e6);
+}
+
+static void bench_split(const char *name, char *buf, const char *sep) {
+    static const char *levels[] = {"avx2", "sse2", "scalar"};
+    int features[] = {-1, RMUTIL_CPU_SSE2, 0};
+    size_t seplen = strlen(sep), expected = count_naive(buf, BENCH_SIZE, sep, seplen), n = 0;
+
+    double start = now_ms();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        n += count_naive(buf, BENCH_SIZE, sep, seplen);
+    }
+    report(name, "naive", start);
+    for (int f = 0; f < 3; f++) {
+        RMUtil_SetCPUFeatures(features[f]);
+        if (f == 0 && !(RMUtil_CPUFeatures() & RMUTIL_CPU_AVX2))
+            continue;
+        start = now_ms();
+        for (int r = 0; r < BENCH_ROUNDS; r++) {
+            n += count_kernel(buf, BENCH_SIZE, sep, seplen);
+        }
+        report(name, levels[f], start);
+        if (count_kernel(buf, BENCH_SIZE, sep, seplen) != expected) {
+            printf("mismatch\n");
+            exit(1);
+        }
+    }
+    RMUtil_SetCPUFeatures(-1);
+}
+
+int main(int argc, char **argv) {
+    static const char *levels[] = {"avx2", "sse2", "scalar"};
+    int features[] = {-1, RMUTIL_CPU_SSE2, 0};
+    char *buf = malloc(BENCH_SIZE);
+
+    // CSV like rows: fields of 1 to 16 letters and digits
+    for (size_t i = 0; i < BENCH_SIZE; i++) {
+        buf[i] = rand() % 10 ? "abcdefghIJKLMNOP0123456789"[rand() % 26] : ',';
+    }
+    bench_split("split ','", buf, ",");
+    bench_split("split 'a,'", buf, "a,");
+    bench_split("split '<sep>'", buf, "<sep>");
+
+    double start = now_ms();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        lower_naive(buf, BENCH_SIZE);
+    }
+    report("tolower", "naive", start);
+    for (int f = 0; f < 3; f++) {
+        RMUtil_SetCPUFeatures(features[f]);
+        if (f == 0 && !(RMUtil_CPUFeatures() & RMUTIL_CPU_AVX2))
+            continue;
+        start = now_ms();
+        for (int r = 0; r < BENCH_ROUNDS; r++) {
+            RMUtil_ASCIIToLower(buf, BENCH_SIZE);
+        }
+        report("tolower", levels[f], start);
+    }
+    RMUtil_SetCPUFeatures(-1);
+
+    free(buf);
+    return 0;
+}
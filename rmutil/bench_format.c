@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "format.h"
+#include "sds.h"
+
+/* Benchmark integer and double formatting against the divide by 10 loop sds used before and the printf family, and
+ * building a reply of numbers with sdscatfmt and sdscatprintf */
+
+#define BENCH_COUNT 1000000
+
+static double now_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+/* The previous sdsll2str: digits in reverse, then a reverse pass */
+static int ll2str_div10(char *s, long long value) {
+    char *p = s, aux;
+    unsigned long long v = (value < 0) ? -(unsigned long long)value : value;
+    do {
+        *p++ = '0' + (v % 10);
+        v /= 10;
+    } while (v);
+    if (value < 0)
+        *p++ = '-';
+    int l = p - s;
+    *p-- = '\0';
+    while (s < p) {
+        aux = *s;
+        *s++ = *p;
+        *p-- = aux;
+    }
+    return l;
+}
+
+static void report(const char *name, double start, size_t bytes) {
+    double ms = now_ms() - start;
+    printf("%-28s %8.2f ms %8.1f ns/number  (%zu bytes)\n", name, ms, ms * 1e6 / BENCH_COUNT, bytes);
+}
+
+int main(int argc, char **argv) {
+    long long *ints = malloc(BENCH_COUNT * sizeof(long long));
+    double *doubles = malloc(BENCH_COUNT * sizeof(double));
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        ints[i] = ((long long)rand() << 31 | rand()) >> (rand() % 62);
+        ints[i] = rand() % 2 ? ints[i] : -ints[i];
+        doubles[i] = (double)rand() / rand() * (rand() % 2 ? 1e-3 : 1e6);
+    }
+    char buf[RMUTIL_FMT_DOUBLE_FIXED_SIZE];
+    size_t bytes = 0;
+
+    double start = now_ms();
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        bytes += ll2str_div10(buf, ints[i]);
+    }
+    report("int64 divide by 10", start, bytes);
+    bytes = 0;
+    start = now_ms();
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        bytes += snprintf(buf, sizeof(buf), "%lld", ints[i]);
+    }
+    report("int64 snprintf", start, bytes);
+    bytes = 0;
+    start = now_ms();
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        bytes += RMUtil_FormatI64(buf, ints[i]);
+    }
+    report("int64 RMUtil_FormatI64", start, bytes);
+
+    bytes = 0;
+    start = now_ms();
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        bytes += snprintf(buf, sizeof(buf), "%.17g", doubles[i]);
+    }
+    report("double snprintf %.17g", start, bytes);
+    bytes = 0;
+    start = now_ms();
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        bytes += RMUtil_FormatDouble(buf, doubles[i]);
+    }
+    report("double RMUtil_FormatDouble", start, bytes);
+
+    sds s = sdsempty();
+    start = now_ms();
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        s = sdscatprintf(s, "%lld,%.17g\n", ints[i], doubles[i]);
+    }
+    report("reply sdscatprintf", start, sdslen(s));
+    sdsclear(s);
+    start = now_ms();
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        s = sdscatfmt(s, "%I,%g\n", ints[i], doubles[i]);
+    }
+    report("reply sdscatfmt", start, sdslen(s));
+    sdsfree(s);
+
+    free(ints);
+    free(doubles);
+    return 0;
+}
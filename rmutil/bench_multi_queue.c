@@ -0,0 +1,90 @@
+#include <stdio.h>
+#include <time.h>
+#include "multi_queue.h"
+
+/* Benchmark the throughput of a MultiQueue against a PriorityQueue behind a single mutex, with every thread
+ * alternating pushes and pops on a prefilled queue */
+
+#define PREFILL 100000
+#define OPS_PER_THREAD 500000
+#define QUEUES_PER_THREAD 4
+
+/* Each thread writes its seed, so contexts get a cache line each, like the shards of the queue */
+typedef struct {
+    MultiQueue *mq;
+    PriorityQueue *pq;
+    pthread_mutex_t *lock;
+    unsigned seed;
+} __attribute__((aligned(64))) worker_ctx;
+
+static int cmp(void *i1, void *i2) {
+    int *__i1 = (int *)i1;
+    int *__i2 = (int *)i2;
+    return *__i1 - *__i2;
+}
+
+static double now_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static void *multi_queue_worker(void *arg) {
+    worker_ctx *ctx = arg;
+    int n;
+    for (int i = 0; i < OPS_PER_THREAD; i++) {
+        Multi_Queue_Push(ctx->mq, (int)rand_r(&ctx->seed));
+        Multi_Queue_Pop(ctx->mq, &n);
+    }
+    return NULL;
+}
+
+static void *locked_queue_worker(void *arg) {
+    worker_ctx *ctx = arg;
+    for (int i = 0; i < OPS_PER_THREAD; i++) {
+        int n = rand_r(&ctx->seed);
+        pthread_mutex_lock(ctx->lock);
+        Priority_Queue_Push(ctx->pq, n);
+        pthread_mutex_unlock(ctx->lock);
+        pthread_mutex_lock(ctx->lock);
+        Priority_Queue_Pop(ctx->pq);
+        pthread_mutex_unlock(ctx->lock);
+    }
+    return NULL;
+}
+
+static double run(int threads, void *(*worker)(void *), MultiQueue *mq, PriorityQueue *pq, pthread_mutex_t *lock) {
+    pthread_t tids[threads];
+    worker_ctx ctx[threads];
+    double start = now_ms();
+    for (int t = 0; t < threads; t++) {
+        ctx[t] = (worker_ctx){mq, pq, lock, t + 1};
+        pthread_create(&tids[t], NULL, worker, &ctx[t]);
+    }
+    for (int t = 0; t < threads; t++) {
+        pthread_join(tids[t], NULL);
+    }
+    double ms = now_ms() - start;
+    // push and pop count as one operation each
+    return 2.0 * threads * OPS_PER_THREAD / ms / 1000.0;
+}
+
+int main(int argc, char **argv) {
+    for (int threads = 1; threads <= 8; threads *= 2) {
+        MultiQueue *mq = NewMultiQueue(int, threads * QUEUES_PER_THREAD, cmp);
+        PriorityQueue *pq = NewPriorityQueue(int, PREFILL, cmp);
+        pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+        for (int i = 0; i < PREFILL; i++) {
+            Multi_Queue_Push(mq, rand());
+            Priority_Queue_Push(pq, rand());
+        }
+
+        double multi = run(threads, multi_queue_worker, mq, NULL, NULL);
+        double locked = run(threads, locked_queue_worker, NULL, pq, &lock);
+        printf("threads %d  multi queue %8.2f Mops/s  locked priority queue %8.2f Mops/s\n", threads, multi, locked);
+
+        Multi_Queue_Free(mq);
+        Priority_Queue_Free(pq);
+    }
+    return 0;
+}
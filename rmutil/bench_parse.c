@@ -0,0 +1,72 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include "parse.h"
+
+/* Benchmark parsing integers and doubles against strtoll() and strtod(), which Redis uses behind
+ * RedisModule_StringToLongLong and RedisModule_StringToDouble */
+
+#define BENCH_COUNT 1000000
+#define BENCH_WIDTH 32
+
+static double now_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static void report(const char *name, double start, double sum) {
+    double ms = now_ms() - start;
+    printf("%-24s %8.2f ms %8.1f ns/number  (checksum %g)\n", name, ms, ms * 1e6 / BENCH_COUNT, sum);
+}
+
+int main(int argc, char **argv) {
+    char *ints = malloc(BENCH_COUNT * BENCH_WIDTH), *doubles = malloc(BENCH_COUNT * BENCH_WIDTH);
+    size_t *intLens = malloc(BENCH_COUNT * sizeof(size_t)), *doubleLens = malloc(BENCH_COUNT * sizeof(size_t));
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        long long v = ((long long)rand() << 31 | rand()) >> (rand() % 62);
+        intLens[i] = sprintf(ints + i * BENCH_WIDTH, "%lld", rand() % 2 ? v : -v);
+        double d = (double)rand() / rand() * (rand() % 2 ? 1e-3 : 1e6);
+        // prices and scores with a few decimals, and full precision values
+        doubleLens[i] = sprintf(doubles + i * BENCH_WIDTH, i % 2 ? "%.2f" : "%.17g", d);
+    }
+
+    double sum = 0, start = now_ms();
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        errno = 0;
+        sum += strtoll(ints + i * BENCH_WIDTH, NULL, 10);
+    }
+    report("strtoll", start, sum);
+    sum = 0;
+    start = now_ms();
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        long long v = 0;
+        RMUtil_ParseLongLong(ints + i * BENCH_WIDTH, intLens[i], &v);
+        sum += v;
+    }
+    report("RMUtil_ParseLongLong", start, sum);
+
+    sum = 0;
+    start = now_ms();
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        errno = 0;
+        sum += strtod(doubles + i * BENCH_WIDTH, NULL);
+    }
+    report("strtod", start, sum);
+    sum = 0;
+    start = now_ms();
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        double d = 0;
+        RMUtil_ParseDouble(doubles + i * BENCH_WIDTH, doubleLens[i], &d);
+        sum += d;
+    }
+    report("RMUtil_ParseDouble", start, sum);
+
+    free(ints);
+    free(doubles);
+    free(intLens);
+    free(doubleLens);
+    return 0;
+}
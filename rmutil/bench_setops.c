@@ -0,0 +1,83 @@
+#include <stdio.h>
+#include <time.h>
+#include "setops.h"
+#include "simd.h"
+
+/* Benchmark set operations on sorted uint32/uint64 vectors, comparing the scalar, SSE4.2 and AVX2 kernels, and
+ * galloping for skewed input sizes */
+
+#define BENCH_ROUNDS 20
+
+static double now_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static void fill_sorted(Vector *v, size_t n, int density) {
+    v->top = 0;
+    uint64_t x = 0;
+    while (Vector_Size(v) < n) {
+        x += 1 + rand() % density;
+        if (v->elemSize == 4) {
+            uint32_t y = x;
+            __vector_PushPtr(v, &y);
+        } else {
+            __vector_PushPtr(v, &x);
+        }
+    }
+}
+
+typedef size_t (*setop)(Vector *, Vector *, Vector *);
+
+static void bench(const char *name, setop op, Vector *a, Vector *b, Vector *out) {
+    static const char *levels[] = {"avx2", "sse4.2", "scalar"};
+    int features[] = {-1, RMUTIL_CPU_SSE2 | RMUTIL_CPU_SSE42, 0};
+
+    for (int f = 0; f < 3; f++) {
+        RMUtil_SetCPUFeatures(features[f]);
+        if (f == 0 && !(RMUtil_CPUFeatures() & RMUTIL_CPU_AVX2))
+            continue;
+        if (f == 1 && !(RMUtil_CPUFeatures() & RMUTIL_CPU_SSE42))
+            continue;
+
+        size_t n = 0;
+        double start = now_ms();
+        for (int r = 0; r < BENCH_ROUNDS; r++) {
+            n += op(a, b, out);
+        }
+        double ms = (now_ms() - start) / BENCH_ROUNDS;
+        printf("%-16s %-7s |a|=%-8zu |b|=%-8zu result=%-8zu %8.3f ms %8.1f Melem/s\n", name, levels[f], a->top,
+               b->top, n / BENCH_ROUNDS, ms, (a->top + b->top) / ms / 1000.0);
+    }
+    RMUtil_SetCPUFeatures(-1);
+}
+
+int main(int argc, char **argv) {
+    size_t N = 1000000;
+    for (int width = 4; width <= 8; width += 4) {
+        Vector *a = __newVectorSize(width, 0);
+        Vector *b = __newVectorSize(width, 0);
+        Vector *out = __newVectorSize(width, 0);
+        int u32 = width == 4;
+
+        printf("--- uint%d ---\n", width * 8);
+        for (int density = 2; density <= 16; density *= 4) {
+            fill_sorted(a, N, density);
+            fill_sorted(b, N, density);
+            bench("intersect", u32 ? Vector_IntersectU32 : Vector_IntersectU64, a, b, out);
+            bench("difference", u32 ? Vector_DifferenceU32 : Vector_DifferenceU64, a, b, out);
+            bench("union", u32 ? Vector_UnionU32 : Vector_UnionU64, a, b, out);
+        }
+
+        // skewed sizes take the galloping path regardless of the kernel
+        fill_sorted(a, N / 1000, 1000);
+        fill_sorted(b, N, 1);
+        bench("intersect/gallop", u32 ? Vector_IntersectU32 : Vector_IntersectU64, a, b, out);
+
+        Vector_Free(a);
+        Vector_Free(b);
+        Vector_Free(out);
+    }
+    return 0;
+}
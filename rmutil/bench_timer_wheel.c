@@ -0,0 +1,89 @@
+#include <stdio.h>
+#include <time.h>
+#include "timer_wheel.h"
+#include "priority_queue.h"
+
+/* Benchmark the timer wheel against a PriorityQueue keyed by deadline, scheduling timers, cancelling half of them and
+ * then running the clock until all have expired. The priority queue cannot cancel, so it marks cancelled timers and
+ * skips them when they reach the top */
+
+#define TIMERS 1000000
+#define SPREAD 60000
+
+typedef struct {
+    uint64_t expires;
+    size_t id;
+} timer;
+
+// earliest deadline on top
+static int timer_cmp(void *a, void *b) {
+    uint64_t x = ((timer *)a)->expires, y = ((timer *)b)->expires;
+    return (x > y) - (x < y);
+}
+
+static double now_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static uint64_t deadlines[TIMERS];
+static char cancelled[TIMERS];
+static TimerWheelNode *handles[TIMERS];
+
+int main(int argc, char **argv) {
+    uint64_t start = 1000000;
+    for (size_t i = 0; i < TIMERS; i++) {
+        deadlines[i] = start + 1 + rand() % SPREAD;
+    }
+
+    // timer wheel
+    TimerWheel *tw = NewTimerWheel(start);
+    double t0 = now_ms();
+    for (size_t i = 0; i < TIMERS; i++) {
+        handles[i] = Timer_Wheel_Schedule(tw, deadlines[i], (void *)i);
+    }
+    double t1 = now_ms();
+    for (size_t i = 0; i < TIMERS; i += 2) {
+        Timer_Wheel_Cancel(tw, handles[i]);
+    }
+    double t2 = now_ms();
+    size_t fired = 0;
+    TimerWheelEntry out[256];
+    for (uint64_t now = start + 1; now <= start + SPREAD; now++) {
+        size_t n;
+        while ((n = Timer_Wheel_Tick(tw, now, out, 256)) > 0) {
+            fired += n;
+        }
+    }
+    double t3 = now_ms();
+    printf("timer wheel     schedule %8.2f ms  cancel %8.2f ms  expire %8.2f ms  fired %zu\n", t1 - t0, t2 - t1,
+           t3 - t2, fired);
+    Timer_Wheel_Free(tw);
+
+    // priority queue
+    PriorityQueue *pq = NewPriorityQueue(timer, 0, timer_cmp);
+    t0 = now_ms();
+    for (size_t i = 0; i < TIMERS; i++) {
+        timer t = {deadlines[i], i};
+        __priority_Queue_PushPtr(pq, &t);
+    }
+    t1 = now_ms();
+    for (size_t i = 0; i < TIMERS; i += 2) {
+        cancelled[i] = 1;
+    }
+    t2 = now_ms();
+    fired = 0;
+    for (uint64_t now = start + 1; now <= start + SPREAD; now++) {
+        timer t;
+        while (Priority_Queue_Top(pq, &t) && t.expires <= now) {
+            Priority_Queue_Pop(pq);
+            fired += !cancelled[t.id];
+        }
+    }
+    t3 = now_ms();
+    printf("priority queue  schedule %8.2f ms  cancel %8.2f ms  expire %8.2f ms  fired %zu\n", t1 - t0, t2 - t1,
+           t3 - t2, fired);
+    Priority_Queue_Free(pq);
+    return 0;
+}
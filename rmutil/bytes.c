@@ -0,0 +1,172 @@
+#include <string.h>
+#include "bytes.h"
+#include "simd.h"
+
+#ifdef RMUTIL_X86_SIMD
+#include <immintrin.h>
+#endif
+
+/* Scalar kernels, also used for the tails of the SIMD ones */
+
+/* Find sep, seplen >= 2, from position i on. Only the positions holding the first byte are compared further */
+static const char *__findSep_scalar(const char *p, size_t n, size_t i, const char *sep, size_t seplen) {
+    while (i + seplen <= n) {
+        const char *m = memchr(p + i, sep[0], n - i - (seplen - 1));
+        if (!m)
+            return NULL;
+        if (!memcmp(m + 1, sep + 1, seplen - 1))
+            return m;
+        i = m - p + 1;
+    }
+    return NULL;
+}
+
+/* Flip the case of the bytes in [first, first + 26) from position i on. The unsigned subtraction maps the range to
+ * [0, 26) and everything else above it, so there is no branch */
+static void __flipCase_scalar(char *p, size_t n, size_t i, unsigned char first) {
+    for (; i < n; i++) {
+        unsigned char c = p[i];
+        p[i] = c ^ (((unsigned char)(c - first) < 26) << 5);
+    }
+}
+
+#ifdef RMUTIL_X86_SIMD
+
+/* Multi byte separators compare the first byte of the separator at every position of a block, and its last byte
+ * seplen - 1 positions further, with one bit per position in a movemask. Only positions matching both are compared
+ * in full, which filters out nearly all of them even when the first byte is frequent. Blocks are scanned in groups of
+ * FINDSEP_GROUP, and when a whole group does not hold the first byte it is rare, so memchr skips ahead faster than
+ * the blocks would. Checking once per group keeps that branch predictable */
+#define FINDSEP_GROUP 4
+
+RMUTIL_TARGET("sse2")
+static const char *__findSep_sse2(const char *p, size_t n, const char *sep, size_t seplen) {
+    const __m128i first = _mm_set1_epi8(sep[0]);
+    const __m128i last = _mm_set1_epi8(sep[seplen - 1]);
+    size_t i = 0;
+    while (i + seplen - 1 + 16 * FINDSEP_GROUP <= n) {
+        __m128i any = _mm_setzero_si128();
+        for (int b = 0; b < FINDSEP_GROUP; b++, i += 16) {
+            __m128i f = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(p + i)), first);
+            __m128i l = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(p + i + seplen - 1)), last);
+            any = _mm_or_si128(any, f);
+            for (unsigned mask = _mm_movemask_epi8(_mm_and_si128(f, l)); mask; mask &= mask - 1) {
+                const char *m = p + i + __builtin_ctz(mask);
+                if (!memcmp(m + 1, sep + 1, seplen - 2))
+                    return m;
+            }
+        }
+        if (!_mm_movemask_epi8(any)) {
+            const char *m = memchr(p + i, sep[0], n - (seplen - 1) - i);
+            if (!m)
+                return NULL;
+            i = m - p;
+        }
+    }
+    return __findSep_scalar(p, n, i, sep, seplen);
+}
+
+RMUTIL_TARGET("avx2")
+static const char *__findSep_avx2(const char *p, size_t n, const char *sep, size_t seplen) {
+    const __m256i first = _mm256_set1_epi8(sep[0]);
+    const __m256i last = _mm256_set1_epi8(sep[seplen - 1]);
+    size_t i = 0;
+    while (i + seplen - 1 + 32 * FINDSEP_GROUP <= n) {
+        __m256i any = _mm256_setzero_si256();
+        for (int b = 0; b < FINDSEP_GROUP; b++, i += 32) {
+            __m256i f = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(p + i)), first);
+            __m256i l = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(p + i + seplen - 1)), last);
+            any = _mm256_or_si256(any, f);
+            for (unsigned mask = _mm256_movemask_epi8(_mm256_and_si256(f, l)); mask; mask &= mask - 1) {
+                const char *m = p + i + __builtin_ctz(mask);
+                if (!memcmp(m + 1, sep + 1, seplen - 2))
+                    return m;
+            }
+        }
+        if (_mm256_testz_si256(any, any)) {
+            const char *m = memchr(p + i, sep[0], n - (seplen - 1) - i);
+            if (!m)
+                return NULL;
+            i = m - p;
+        }
+    }
+    return __findSep_scalar(p, n, i, sep, seplen);
+}
+
+/* Case conversion shifts the bytes by 128 - first, which moves the letters to the lowest 26 signed values, so one
+ * signed comparison selects them */
+
+RMUTIL_TARGET("sse2")
+static void __flipCase_sse2(char *p, size_t n, unsigned char first) {
+    const __m128i shift = _mm_set1_epi8((char)(0x80 - first));
+    const __m128i limit = _mm_set1_epi8(-128 + 26);
+    const __m128i bit = _mm_set1_epi8(0x20);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+        __m128i letters = _mm_cmplt_epi8(_mm_add_epi8(v, shift), limit);
+        _mm_storeu_si128((__m128i *)(p + i), _mm_xor_si128(v, _mm_and_si128(letters, bit)));
+    }
+    __flipCase_scalar(p, n, i, first);
+}
+
+RMUTIL_TARGET("avx2")
+static void __flipCase_avx2(char *p, size_t n, unsigned char first) {
+    const __m256i shift = _mm256_set1_epi8((char)(0x80 - first));
+    const __m256i limit = _mm256_set1_epi8(-128 + 26);
+    const __m256i bit = _mm256_set1_epi8(0x20);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(p + i));
+        __m256i letters = _mm256_cmpgt_epi8(limit, _mm256_add_epi8(v, shift));
+        _mm256_storeu_si256((__m256i *)(p + i), _mm256_xor_si256(v, _mm256_and_si256(letters, bit)));
+    }
+    __flipCase_scalar(p, n, i, first);
+}
+
+#endif // RMUTIL_X86_SIMD
+
+// libc memchr is already vectorized, and faster than a kernel of our own
+const char *RMUtil_FindByte(const char *p, size_t n, char c) {
+    return memchr(p, c, n);
+}
+
+const char *RMUtil_FindSep(const char *p, size_t n, const char *sep, size_t seplen) {
+    if (seplen == 0)
+        return p;
+    if (seplen == 1)
+        return RMUtil_FindByte(p, n, sep[0]);
+    if (seplen > n)
+        return NULL;
+#ifdef RMUTIL_X86_SIMD
+    int features = RMUtil_CPUFeatures();
+    if (features & RMUTIL_CPU_AVX2)
+        return __findSep_avx2(p, n, sep, seplen);
+    if (features & RMUTIL_CPU_SSE2)
+        return __findSep_sse2(p, n, sep, seplen);
+#endif
+    return __findSep_scalar(p, n, 0, sep, seplen);
+}
+
+static void __flipCase(char *p, size_t n, unsigned char first) {
+#ifdef RMUTIL_X86_SIMD
+    int features = RMUtil_CPUFeatures();
+    if (features & RMUTIL_CPU_AVX2) {
+        __flipCase_avx2(p, n, first);
+        return;
+    }
+    if (features & RMUTIL_CPU_SSE2) {
+        __flipCase_sse2(p, n, first);
+        return;
+    }
+#endif
+    __flipCase_scalar(p, n, 0, first);
+}
+
+void RMUtil_ASCIIToLower(char *p, size_t n) {
+    __flipCase(p, n, 'A');
+}
+
+void RMUtil_ASCIIToUpper(char *p, size_t n) {
+    __flipCase(p, n, 'a');
+}
@@ -0,0 +1,27 @@
+#ifndef __RMUTIL_BYTES_H__
+#define __RMUTIL_BYTES_H__
+
+#include <stddef.h>
+
+/* Byte string kernels
+ * Separator search and ASCII case conversion over buffers of known length. Single bytes are searched with memchr,
+ * which libc already vectorizes. Multi byte separators and case conversion use AVX2 kernels when the CPU supports
+ * them and SSE2 kernels otherwise (see simd.h), with scalar fallbacks on other CPUs and architectures.
+ * All the functions are binary safe: NUL bytes are ordinary bytes and the buffers need no terminator.
+ */
+
+/* Return a pointer to the first occurrence of the byte c in p[0, n), or NULL if there is none */
+const char *RMUtil_FindByte(const char *p, size_t n, char c);
+
+/* Return a pointer to the first occurrence of sep[0, seplen) in p[0, n), or NULL if there is none.
+ * An empty separator matches at p */
+const char *RMUtil_FindSep(const char *p, size_t n, const char *sep, size_t seplen);
+
+/* Convert the ASCII letters A-Z of p[0, n) to lowercase in place. Other bytes, including non ASCII ones, are left
+ * unchanged, like tolower() in the C locale */
+void RMUtil_ASCIIToLower(char *p, size_t n);
+
+/* Convert the ASCII letters a-z of p[0, n) to uppercase in place */
+void RMUtil_ASCIIToUpper(char *p, size_t n);
+
+#endif //__RMUTIL_BYTES_H__
@@ -0,0 +1,122 @@
+#include "chunked_vector.h"
+
+static inline size_t __chunked_Vector_ChunkBytes(ChunkedVector *cv) {
+  return ((size_t)1 << cv->chunkShift) * cv->elemSize;
+}
+
+/* Allocate zeroed chunks until the vector can hold n elements */
+static void __chunked_Vector_Grow(ChunkedVector *cv, size_t n) {
+  size_t need = (n + ((size_t)1 << cv->chunkShift) - 1) >> cv->chunkShift;
+  if (need <= cv->numChunks) {
+    return;
+  }
+
+  if (need > cv->chunksCap) {
+    size_t newcap = cv->chunksCap ? cv->chunksCap * 2 : 8;
+    while (newcap < need) {
+      newcap *= 2;
+    }
+    cv->chunks = realloc(cv->chunks, newcap * sizeof(char *));
+    cv->chunksCap = newcap;
+  }
+
+  while (cv->numChunks < need) {
+    cv->chunks[cv->numChunks++] = calloc(1, __chunked_Vector_ChunkBytes(cv));
+  }
+}
+
+/* Zero the elements in [first, last), which may span several chunks */
+static void __chunked_Vector_Zero(ChunkedVector *cv, size_t first,
+                                  size_t last) {
+  size_t chunkCap = (size_t)1 << cv->chunkShift;
+  while (first < last) {
+    size_t end = (first | (chunkCap - 1)) + 1;
+    if (end > last) {
+      end = last;
+    }
+    memset(__chunked_Vector_GetPtr(cv, first), 0, (end - first) * cv->elemSize);
+    first = end;
+  }
+}
+
+ChunkedVector *__newChunkedVectorSize(size_t elemSize, size_t chunkCap) {
+  ChunkedVector *cv = malloc(sizeof(ChunkedVector));
+  if (chunkCap == 0) {
+    chunkCap = CHUNKED_VECTOR_DEFAULT_CHUNK;
+  }
+  cv->chunkShift = 0;
+  while (((size_t)1 << cv->chunkShift) < chunkCap) {
+    cv->chunkShift++;
+  }
+  cv->elemSize = elemSize;
+  cv->chunks = NULL;
+  cv->numChunks = 0;
+  cv->chunksCap = 0;
+  cv->top = 0;
+  return cv;
+}
+
+int Chunked_Vector_Get(ChunkedVector *cv, size_t pos, void *ptr) {
+  if (pos >= cv->top) {
+    return 0;
+  }
+  memcpy(ptr, __chunked_Vector_GetPtr(cv, pos), cv->elemSize);
+  return 1;
+}
+
+int Chunked_Vector_Pop(ChunkedVector *cv, void *ptr) {
+  if (cv->top == 0) {
+    return 0;
+  }
+  cv->top--;
+  if (ptr != NULL) {
+    memcpy(ptr, __chunked_Vector_GetPtr(cv, cv->top), cv->elemSize);
+  }
+  return 1;
+}
+
+int __chunked_Vector_PutPtr(ChunkedVector *cv, size_t pos, void *elem) {
+  __chunked_Vector_Grow(cv, pos + 1);
+
+  // elements between the old end and pos may hold popped values
+  if (pos > cv->top) {
+    __chunked_Vector_Zero(cv, cv->top, pos);
+  }
+
+  char *p = __chunked_Vector_GetPtr(cv, pos);
+  if (elem) {
+    memcpy(p, elem, cv->elemSize);
+  } else {
+    memset(p, 0, cv->elemSize);
+  }
+  if (pos >= cv->top) {
+    cv->top = pos + 1;
+  }
+  return 1;
+}
+
+int __chunked_Vector_PushPtr(ChunkedVector *cv, void *elem) {
+  __chunked_Vector_PutPtr(cv, cv->top, elem);
+  return cv->top;
+}
+
+size_t Chunked_Vector_Size(ChunkedVector *cv) { return cv->top; }
+
+size_t Chunked_Vector_Cap(ChunkedVector *cv) {
+  return cv->numChunks << cv->chunkShift;
+}
+
+void Chunked_Vector_ShrinkToFit(ChunkedVector *cv) {
+  size_t need = (cv->top + ((size_t)1 << cv->chunkShift) - 1) >> cv->chunkShift;
+  while (cv->numChunks > need) {
+    free(cv->chunks[--cv->numChunks]);
+  }
+}
+
+void Chunked_Vector_Free(ChunkedVector *cv) {
+  for (size_t i = 0; i < cv->numChunks; i++) {
+    free(cv->chunks[i]);
+  }
+  free(cv->chunks);
+  free(cv);
+}
@@ -0,0 +1,92 @@
+#ifndef __CHUNKED_VECTOR_H__
+#define __CHUNKED_VECTOR_H__
+#include <stdlib.h>
+#include <string.h>
+
+/*
+* Segmented vector for very large collections.
+* Elements are stored in fixed size chunks that are allocated as the vector
+* grows. Unlike Vector, growing never moves existing elements, so element
+* pointers stay valid and there are no large realloc copies. Only the small
+* directory of chunk pointers is reallocated.
+* Indexing is O(1): the number of elements per chunk is a power of two.
+*/
+typedef struct {
+  char **chunks;
+  size_t numChunks;
+  size_t chunksCap;
+  size_t elemSize;
+  size_t chunkShift;
+  size_t top;
+} ChunkedVector;
+
+/* Default number of elements per chunk */
+#define CHUNKED_VECTOR_DEFAULT_CHUNK 4096
+
+/* Create a new chunked vector with element size and the number of elements
+ * per chunk. This should generally be used by the NewChunkedVector macro */
+ChunkedVector *__newChunkedVectorSize(size_t elemSize, size_t chunkCap);
+
+/*
+* Create a new chunked vector for a given type, with chunkCap elements per
+* chunk. chunkCap is rounded up to a power of two, and 0 means
+* CHUNKED_VECTOR_DEFAULT_CHUNK.
+* e.g. NewChunkedVector(uint64_t, 0)
+*/
+#define NewChunkedVector(type, chunkCap)                                       \
+  __newChunkedVectorSize(sizeof(type), chunkCap)
+
+/* Get a pointer to the element at pos without bounds checking. To be used
+ * internally by the library */
+static inline char *__chunked_Vector_GetPtr(ChunkedVector *cv, size_t pos) {
+  size_t mask = ((size_t)1 << cv->chunkShift) - 1;
+  return cv->chunks[pos >> cv->chunkShift] + (pos & mask) * cv->elemSize;
+}
+
+/*
+* Get a pointer to the element at pos, or NULL if pos is outside the vector
+* size. Since chunks never move, the pointer stays valid as the vector grows.
+*/
+static inline void *Chunked_Vector_GetPtr(ChunkedVector *cv, size_t pos) {
+  return pos < cv->top ? __chunked_Vector_GetPtr(cv, pos) : NULL;
+}
+
+/* Copy the element at pos to ptr. Returns 0 if pos is out of bounds, 1
+ * otherwise */
+int Chunked_Vector_Get(ChunkedVector *cv, size_t pos, void *ptr);
+
+/* Remove the element at the end of the vector, copying it to ptr if it is not
+ * NULL. Chunks are kept allocated for reuse */
+int Chunked_Vector_Pop(ChunkedVector *cv, void *ptr);
+
+// Put a pointer in the vector. To be used internally by the library
+int __chunked_Vector_PutPtr(ChunkedVector *cv, size_t pos, void *elem);
+
+// Push a pointer in the vector. To be used internally by the library
+int __chunked_Vector_PushPtr(ChunkedVector *cv, void *elem);
+
+/*
+* Put an element at pos.
+* Note: If pos is outside the vector capacity, chunks are added accordingly
+*/
+#define Chunked_Vector_Put(cv, pos, elem)                                      \
+  __chunked_Vector_PutPtr(cv, pos, elem ? &(typeof(elem)){elem} : NULL)
+
+/* Push an element at the end of cv, adding a chunk if needed */
+#define Chunked_Vector_Push(cv, elem)                                          \
+  __chunked_Vector_PushPtr(cv, elem ? &(typeof(elem)){elem} : NULL)
+
+/* return the used size of the vector */
+size_t Chunked_Vector_Size(ChunkedVector *cv);
+
+/* return the capacity of the allocated chunks */
+size_t Chunked_Vector_Cap(ChunkedVector *cv);
+
+/* free chunks that are entirely past the end of the vector */
+void Chunked_Vector_ShrinkToFit(ChunkedVector *cv);
+
+/* free the vector and all its chunks. Does not release its elements if they
+ * are pointers */
+void Chunked_Vector_Free(ChunkedVector *cv);
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef __RMUTIL_FORMAT_H__
+#define __RMUTIL_FORMAT_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Number formatting
+ * Integer and double to string conversion that does not go through the printf family. Integers are converted two
+ * digits at a time with a lookup table. Doubles are converted with the Ryu algorithm, which finds the shortest
+ * decimal string that reads back as the same double, so the output round trips through strtod() and is usually
+ * much shorter than %.17g.
+ *
+ * All the functions write a NULL terminated string to buf and return its length, not counting the terminator.
+ * buf must have room for the RMUTIL_FMT_*_SIZE bytes of the function, terminator included.
+ */
+
+/* Room needed by RMUtil_FormatI64 and RMUtil_FormatU64 */
+#define RMUTIL_FMT_INT_SIZE 21
+
+/* Room needed by RMUtil_FormatDouble */
+#define RMUTIL_FMT_DOUBLE_SIZE 25
+
+/* Room needed by RMUtil_FormatDoubleFixed: the sign, "0." and 324 digits for the smallest subnormal */
+#define RMUTIL_FMT_DOUBLE_FIXED_SIZE 330
+
+size_t RMUtil_FormatU64(char *buf, uint64_t v);
+
+size_t RMUtil_FormatI64(char *buf, int64_t v);
+
+/* Format v with the shortest digits that round trip, in decimal notation when its decimal exponent is in
+ * [-4, 17), and in scientific notation otherwise, like %g does, e.g. 0.1, 1234.5, 1e+100, -2.5e-07.
+ * Infinities and NaN are written inf, -inf and nan */
+size_t RMUtil_FormatDouble(char *buf, double v);
+
+/* Format v with the shortest digits that round trip, always in decimal notation, e.g. 1e22 is written
+ * 10000000000000000000000 and 1e-7 is written 0.0000001 */
+size_t RMUtil_FormatDoubleFixed(char *buf, double v);
+
+#endif //__RMUTIL_FORMAT_H__
@@ -1,23 +1,26 @@
 #include "heap.h"
 
-/* Byte-wise swap two items of size SIZE. */
-#define SWAP(a, b, size)                      \
-  do                                          \
-    {                                         \
-      register size_t __size = (size);        \
-      register char *__a = (a), *__b = (b);   \
-      do                                      \
-        {                                     \
-          char __tmp = *__a;                  \
-          *__a++ = *__b;                      \
-          *__b++ = __tmp;                     \
-        } while (--__size > 0);               \
+/* Swap two items of size SIZE, a word at a time and then byte-wise for the remainder. The words are copied with
+ * memcpy since elements are not necessarily aligned; it compiles to plain loads and stores. */
+#define SWAP(a, b, size)                                                                                             \
+    do {                                                                                                             \
+        size_t __size = (size);                                                                                      \
+        char *__a = (a), *__b = (b);                                                                                 \
+        for (; __size >= sizeof(size_t); __size -= sizeof(size_t)) {                                                 \
+            size_t __tmp;                                                                                            \
+            memcpy(&__tmp, __a, sizeof(size_t));                                                                     \
+            memcpy(__a, __b, sizeof(size_t));                                                                        \
+            memcpy(__b, &__tmp, sizeof(size_t));                                                                     \
+            __a += sizeof(size_t);                                                                                   \
+            __b += sizeof(size_t);                                                                                   \
+        }                                                                                                            \
+        for (; __size > 0; __size--) {                                                                               \
+            char __tmp = *__a;                                                                                       \
+            *__a++ = *__b;                                                                                           \
+            *__b++ = __tmp;                                                                                          \
+        }                                                                                                            \
     } while (0)
 
-inline char *__vector_GetPtr(Vector *v, size_t pos) {
-    return v->data + (pos * v->elemSize);
-}
-
 void __sift_up(Vector *v, size_t first, size_t last, int (*cmp)(void *, void *)) {
     size_t len = last - first;
     if (len > 1) {
@@ -105,3 +108,102 @@ inline void Heap_Pop(Vector *v, size_t first, size_t last, int (*cmp)(void *, vo
         __sift_down(v, first, last, cmp, first);
     }
 }
+
+
+void Heap_ReplaceTop(Vector *v, size_t first, size_t last, int (*cmp)(void *, void *), void *elem) {
+    memcpy(__vector_GetPtr(v, first), elem, v->elemSize);
+    __sift_down(v, first, last, cmp, first);
+}
+
+
+/* Move the element at last-1 up the d-ary heap range [first,last) */
+static void __sift_up_arity(Vector *v, size_t first, size_t last, int (*cmp)(void *, void *), int arity) {
+    size_t child = last - first - 1;
+    if (child == 0)
+        return;
+
+    size_t parent = (child - 1) / arity;
+    if (cmp(__vector_GetPtr(v, first + parent), __vector_GetPtr(v, first + child)) >= 0)
+        return;
+
+    char t[v->elemSize];
+    memcpy(t, __vector_GetPtr(v, first + child), v->elemSize);
+    do {
+        memcpy(__vector_GetPtr(v, first + child), __vector_GetPtr(v, first + parent), v->elemSize);
+        child = parent;
+        if (child == 0)
+            break;
+        parent = (child - 1) / arity;
+    } while (cmp(__vector_GetPtr(v, first + parent), t) < 0);
+    memcpy(__vector_GetPtr(v, first + child), t, v->elemSize);
+}
+
+/* Move the element at start down the d-ary heap range [first,last) */
+static void __sift_down_arity(Vector *v, size_t first, size_t last, int (*cmp)(void *, void *), int arity,
+                              size_t start) {
+    size_t len = last - first;
+    size_t node = start - first;
+    char top[v->elemSize];
+    int moved = 0;
+
+    // the children of node are at arity * node + 1 ... arity * node + arity
+    while (arity * node + 1 < len) {
+        size_t child = arity * node + 1;
+        size_t end = child + arity < len ? child + arity : len;
+
+        // fetch the grandchildren while we compare the children
+        if (arity * child + 1 < len)
+            __builtin_prefetch(__vector_GetPtr(v, first + arity * child + 1));
+
+        size_t best = child;
+        for (++child; child < end; ++child) {
+            if (cmp(__vector_GetPtr(v, first + best), __vector_GetPtr(v, first + child)) < 0)
+                best = child;
+        }
+
+        if (cmp(__vector_GetPtr(v, first + best), moved ? top : __vector_GetPtr(v, first + node)) < 0)
+            break;
+
+        if (!moved) {
+            memcpy(top, __vector_GetPtr(v, first + node), v->elemSize);
+            moved = 1;
+        }
+        memcpy(__vector_GetPtr(v, first + node), __vector_GetPtr(v, first + best), v->elemSize);
+        node = best;
+    }
+    if (moved)
+        memcpy(__vector_GetPtr(v, first + node), top, v->elemSize);
+}
+
+
+void Make_Heap_Arity(Vector *v, size_t first, size_t last, int (*cmp)(void *, void *), int arity) {
+    if (arity <= 2) {
+        Make_Heap(v, first, last, cmp);
+        return;
+    }
+    if (last - first > 1) {
+        // start from the last parent
+        for (size_t start = (last - first - 2) / arity + 1; start-- > 0;) {
+            __sift_down_arity(v, first, last, cmp, arity, first + start);
+        }
+    }
+}
+
+
+void Heap_Push_Arity(Vector *v, size_t first, size_t last, int (*cmp)(void *, void *), int arity) {
+    if (arity <= 2) {
+        __sift_up(v, first, last, cmp);
+    } else if (last - first > 1) {
+        __sift_up_arity(v, first, last, cmp, arity);
+    }
+}
+
+
+void Heap_Pop_Arity(Vector *v, size_t first, size_t last, int (*cmp)(void *, void *), int arity) {
+    if (arity <= 2) {
+        Heap_Pop(v, first, last, cmp);
+    } else if (last - first > 1) {
+        SWAP(__vector_GetPtr(v, first), __vector_GetPtr(v, --last), v->elemSize);
+        __sift_down_arity(v, first, last, cmp, arity, first);
+    }
+}
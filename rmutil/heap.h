@@ -35,4 +35,153 @@ void Heap_Push(Vector *v, size_t first, size_t last, int (*cmp)(void *, void *))
  */
 void Heap_Pop(Vector *v, size_t first, size_t last, int (*cmp)(void *, void *));
 
+/* Replace the top element of heap range
+ * Overwrites the element with the highest value in the heap range [first,last) with a copy of elem, and restores the
+ * heap property. This is the same as a Heap_Pop followed by a Heap_Push of elem, but takes a single sift-down. It is
+ * the core of bounded heaps, where a new element evicts the top one.
+ * The range must not be empty.
+ */
+void Heap_ReplaceTop(Vector *v, size_t first, size_t last, int (*cmp)(void *, void *), void *elem);
+
+/* d-ary heaps
+ * The same operations on a heap where every node has arity children instead of two. The children of a node are
+ * contiguous, so with arity 4 or 8 they usually share a cache line, and the heap is half or a third as deep. This makes
+ * popping from large heaps cheaper, at the cost of more comparisons per level. Pushes only compare against parents,
+ * so they get cheaper too.
+ * arity must be at least 2, and 2, 4 or 8 are the useful choices. A range must always be used with the same arity;
+ * arity 2 is the layout of Make_Heap, Heap_Push and Heap_Pop.
+ */
+void Make_Heap_Arity(Vector *v, size_t first, size_t last, int (*cmp)(void *, void *), int arity);
+
+void Heap_Push_Arity(Vector *v, size_t first, size_t last, int (*cmp)(void *, void *), int arity);
+
+void Heap_Pop_Arity(Vector *v, size_t first, size_t last, int (*cmp)(void *, void *), int arity);
+
+/* Sift the element at start down the heap range [first,last), restoring the heap property below it.
+ * Used internally by the library */
+void __sift_down(Vector *v, size_t first, size_t last, int (*cmp)(void *, void *), size_t start);
+
+/* Typed heaps
+ * Declare a heap of `type` called `name`, ordered by less_expr, an expression on two elements `a` and `b` that is true
+ * if a orders before b. As with Make_Heap, the greatest element is on top, so use (a > b) for a min-heap.
+ * Comparisons are inlined instead of going through a function pointer, and elements are moved by assignment instead of
+ * memcpy, so they compile to plain loads and stores. The heap arrays are binary heaps.
+ *
+ * This declares range primitives on plain arrays, which work like Make_Heap, Heap_Push and Heap_Pop on [0,n):
+ *   name##_MakeHeap(type *h, size_t n)
+ *   name##_PushHeap(type *h, size_t n)     h[n-1] is the element being added
+ *   name##_PopHeap(type *h, size_t n)      the top element is moved to h[n-1]
+ *
+ * and a priority queue container using them, with an API like PriorityQueue.
+ *
+ * e.g.
+ *   RMUTIL_HEAP_DECLARE(Timer, TimerHeap, a.when > b.when)
+ *
+ *   TimerHeap *h = NewTimerHeap(0);
+ *   TimerHeap_Push(h, t);
+ *   Timer next;
+ *   TimerHeap_Pop(h, &next);
+ *   TimerHeap_Free(h);
+ */
+#define RMUTIL_HEAP_DECLARE(type, name, less_expr)                                                                   \
+    static inline int name##_Less(type a, type b) {                                                                  \
+        return (less_expr);                                                                                          \
+    }                                                                                                                \
+                                                                                                                     \
+    /* fill the hole at i with x, moving the greater children up */                                                  \
+    static inline void __##name##_SiftDown(type *h, size_t n, size_t i, type x) {                                    \
+        size_t child;                                                                                                \
+        while ((child = 2 * i + 1) < n) {                                                                            \
+            if (child + 1 < n && name##_Less(h[child], h[child + 1]))                                                \
+                child++;                                                                                             \
+            if (!name##_Less(x, h[child]))                                                                           \
+                break;                                                                                               \
+            h[i] = h[child];                                                                                         \
+            i = child;                                                                                               \
+        }                                                                                                            \
+        h[i] = x;                                                                                                    \
+    }                                                                                                                \
+                                                                                                                     \
+    /* fill the hole at i with x, moving the lesser parents down */                                                  \
+    static inline void __##name##_SiftUp(type *h, size_t i, type x) {                                                \
+        while (i > 0) {                                                                                              \
+            size_t parent = (i - 1) / 2;                                                                             \
+            if (!name##_Less(h[parent], x))                                                                          \
+                break;                                                                                               \
+            h[i] = h[parent];                                                                                        \
+            i = parent;                                                                                              \
+        }                                                                                                            \
+        h[i] = x;                                                                                                    \
+    }                                                                                                                \
+                                                                                                                     \
+    static inline void name##_MakeHeap(type *h, size_t n) {                                                          \
+        for (size_t i = n / 2; i-- > 0;)                                                                             \
+            __##name##_SiftDown(h, n, i, h[i]);                                                                      \
+    }                                                                                                                \
+                                                                                                                     \
+    static inline void name##_PushHeap(type *h, size_t n) {                                                          \
+        if (n > 1)                                                                                                   \
+            __##name##_SiftUp(h, n - 1, h[n - 1]);                                                                   \
+    }                                                                                                                \
+                                                                                                                     \
+    static inline void name##_PopHeap(type *h, size_t n) {                                                           \
+        if (n > 1) {                                                                                                 \
+            type x = h[n - 1];                                                                                       \
+            h[n - 1] = h[0];                                                                                         \
+            __##name##_SiftDown(h, n - 1, 0, x);                                                                     \
+        }                                                                                                            \
+    }                                                                                                                \
+                                                                                                                     \
+    typedef struct {                                                                                                 \
+        type *data;                                                                                                  \
+        size_t cap;                                                                                                  \
+        size_t top;                                                                                                  \
+    } name;                                                                                                          \
+                                                                                                                     \
+    static inline name *New##name(size_t cap) {                                                                      \
+        name *h = malloc(sizeof(name));                                                                              \
+        h->data = cap ? malloc(cap * sizeof(type)) : NULL;                                                           \
+        h->cap = cap;                                                                                                \
+        h->top = 0;                                                                                                  \
+        return h;                                                                                                    \
+    }                                                                                                                \
+                                                                                                                     \
+    static inline size_t name##_Size(name *h) {                                                                      \
+        return h->top;                                                                                               \
+    }                                                                                                                \
+                                                                                                                     \
+    /* insert elem, return the new size */                                                                           \
+    static inline size_t name##_Push(name *h, type elem) {                                                           \
+        if (h->top == h->cap) {                                                                                      \
+            h->cap = h->cap ? h->cap * 2 : 16;                                                                       \
+            h->data = realloc(h->data, h->cap * sizeof(type));                                                       \
+        }                                                                                                            \
+        __##name##_SiftUp(h->data, h->top++, elem);                                                                  \
+        return h->top;                                                                                               \
+    }                                                                                                                \
+                                                                                                                     \
+    /* copy the top element to ptr. return 0 if the heap is empty */                                                 \
+    static inline int name##_Top(name *h, type *ptr) {                                                               \
+        if (h->top == 0)                                                                                             \
+            return 0;                                                                                                \
+        *ptr = h->data[0];                                                                                           \
+        return 1;                                                                                                    \
+    }                                                                                                                \
+                                                                                                                     \
+    /* remove the top element, copying it to ptr if it is not NULL. return 0 if the heap is empty */                 \
+    static inline int name##_Pop(name *h, type *ptr) {                                                               \
+        if (h->top == 0)                                                                                             \
+            return 0;                                                                                                \
+        if (ptr)                                                                                                     \
+            *ptr = h->data[0];                                                                                       \
+        if (--h->top)                                                                                                \
+            __##name##_SiftDown(h->data, h->top, 0, h->data[h->top]);                                                \
+        return 1;                                                                                                    \
+    }                                                                                                                \
+                                                                                                                     \
+    static inline void name##_Free(name *h) {                                                                        \
+        free(h->data);                                                                                               \
+        free(h);                                                                                                     \
+    }
+
 #endif //__HEAP_H__
@@ -0,0 +1,142 @@
+#include "indexed_priority_queue.h"
+
+#define HEAP(pq) ((size_t *)(pq)->heap->data)
+#define POS(pq) ((size_t *)(pq)->pos->data)
+#define ELEM(pq, handle) __vector_GetPtr((pq)->elems, handle)
+
+IndexedPriorityQueue *__newIndexedPriorityQueueSize(size_t elemSize, size_t cap, int (*cmp)(void *, void *)) {
+    IndexedPriorityQueue *pq = malloc(sizeof(IndexedPriorityQueue));
+    pq->elems = __newVectorSizeFlags(elemSize, cap, VECTOR_NOZERO);
+    pq->heap = __newVectorSizeFlags(sizeof(size_t), cap, VECTOR_NOZERO);
+    pq->pos = __newVectorSizeFlags(sizeof(size_t), cap, VECTOR_NOZERO);
+    pq->freeHandles = __newVectorSizeFlags(sizeof(size_t), 0, VECTOR_NOZERO);
+    pq->cmp = cmp;
+    return pq;
+}
+
+/* Move the handle at heap position i up until its parent compares higher. Returns its new position */
+static size_t __ipq_sift_up(IndexedPriorityQueue *pq, size_t i) {
+    size_t *heap = HEAP(pq), *pos = POS(pq);
+    size_t handle = heap[i];
+    void *elem = ELEM(pq, handle);
+
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (pq->cmp(ELEM(pq, heap[parent]), elem) >= 0)
+            break;
+        heap[i] = heap[parent];
+        pos[heap[i]] = i;
+        i = parent;
+    }
+    heap[i] = handle;
+    pos[handle] = i;
+    return i;
+}
+
+/* Move the handle at heap position i down until both its children compare lower */
+static void __ipq_sift_down(IndexedPriorityQueue *pq, size_t i) {
+    size_t *heap = HEAP(pq), *pos = POS(pq);
+    size_t len = pq->heap->top;
+    size_t handle = heap[i];
+    void *elem = ELEM(pq, handle);
+
+    size_t child;
+    while ((child = 2 * i + 1) < len) {
+        if (child + 1 < len && pq->cmp(ELEM(pq, heap[child]), ELEM(pq, heap[child + 1])) < 0)
+            child++;
+        if (pq->cmp(ELEM(pq, heap[child]), elem) <= 0)
+            break;
+        heap[i] = heap[child];
+        pos[heap[i]] = i;
+        i = child;
+    }
+    heap[i] = handle;
+    pos[handle] = i;
+}
+
+/* Restore the heap order around position i, after the element there changed */
+static void __ipq_fix(IndexedPriorityQueue *pq, size_t i) {
+    if (__ipq_sift_up(pq, i) == i)
+        __ipq_sift_down(pq, i);
+}
+
+inline size_t Indexed_Priority_Queue_Size(IndexedPriorityQueue *pq) {
+    return pq->heap->top;
+}
+
+size_t __indexed_Priority_Queue_PushPtr(IndexedPriorityQueue *pq, void *elem) {
+    size_t handle;
+    if (!Vector_Pop(pq->freeHandles, &handle)) {
+        handle = pq->elems->top;
+        __vector_PushPtr(pq->pos, &(size_t){INDEXED_PRIORITY_QUEUE_NONE});
+    }
+    __vector_PutPtr(pq->elems, handle, elem);
+
+    size_t i = pq->heap->top;
+    __vector_PushPtr(pq->heap, &handle);
+    __ipq_sift_up(pq, i);
+    return handle;
+}
+
+int Indexed_Priority_Queue_Top(IndexedPriorityQueue *pq, void *ptr, size_t *handle) {
+    if (pq->heap->top == 0)
+        return 0;
+    if (ptr)
+        memcpy(ptr, ELEM(pq, HEAP(pq)[0]), pq->elems->elemSize);
+    if (handle)
+        *handle = HEAP(pq)[0];
+    return 1;
+}
+
+int Indexed_Priority_Queue_Pop(IndexedPriorityQueue *pq, void *ptr) {
+    if (pq->heap->top == 0)
+        return 0;
+    return Indexed_Priority_Queue_Remove(pq, HEAP(pq)[0], ptr);
+}
+
+inline int Indexed_Priority_Queue_Contains(IndexedPriorityQueue *pq, size_t handle) {
+    return handle < pq->pos->top && POS(pq)[handle] != INDEXED_PRIORITY_QUEUE_NONE;
+}
+
+int Indexed_Priority_Queue_Get(IndexedPriorityQueue *pq, size_t handle, void *ptr) {
+    if (!Indexed_Priority_Queue_Contains(pq, handle))
+        return 0;
+    memcpy(ptr, ELEM(pq, handle), pq->elems->elemSize);
+    return 1;
+}
+
+int __indexed_Priority_Queue_UpdateKeyPtr(IndexedPriorityQueue *pq, size_t handle, void *elem) {
+    if (!Indexed_Priority_Queue_Contains(pq, handle))
+        return 0;
+    memcpy(ELEM(pq, handle), elem, pq->elems->elemSize);
+    __ipq_fix(pq, POS(pq)[handle]);
+    return 1;
+}
+
+int Indexed_Priority_Queue_Remove(IndexedPriorityQueue *pq, size_t handle, void *ptr) {
+    if (!Indexed_Priority_Queue_Contains(pq, handle))
+        return 0;
+    if (ptr)
+        memcpy(ptr, ELEM(pq, handle), pq->elems->elemSize);
+
+    // fill the hole with the last handle of the heap
+    size_t i = POS(pq)[handle];
+    size_t last = HEAP(pq)[--pq->heap->top];
+    if (i < pq->heap->top) {
+        HEAP(pq)[i] = last;
+        POS(pq)[last] = i;
+        __ipq_fix(pq, i);
+    }
+
+    POS(pq)[handle] = INDEXED_PRIORITY_QUEUE_NONE;
+    __vector_PushPtr(pq->freeHandles, &handle);
+    return 1;
+}
+
+void Indexed_Priority_Queue_Free(IndexedPriorityQueue *pq) {
+    Vector_Free(pq->elems);
+    Vector_Free(pq->heap);
+    Vector_Free(pq->pos);
+    Vector_Free(pq->freeHandles);
+    free(pq);
+}
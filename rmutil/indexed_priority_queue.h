@@ -0,0 +1,78 @@
+#ifndef __INDEXED_PRIORITY_QUEUE_H__
+#define __INDEXED_PRIORITY_QUEUE_H__
+
+#include "vector.h"
+
+/* Indexed priority queue
+ * A priority queue whose elements can be updated or removed after they are pushed. Like PriorityQueue, its top is the
+ * element that compares highest with cmp.
+ * Pushing an element returns a handle that stays valid until the element is popped or removed, after which it may be
+ * reused by a later push. Elements stay in place for their whole life; the heap only orders their handles, so
+ * updates and removals move machine words rather than elements.
+ * Size, Top and Contains are O(1). Push, Pop, UpdateKey and Remove are O(log n).
+ */
+typedef struct {
+    // elements, indexed by handle
+    Vector *elems;
+    // handles, in heap order
+    Vector *heap;
+    // position of each handle in heap, or INDEXED_PRIORITY_QUEUE_NONE if it is not in use
+    Vector *pos;
+    // handles that are not in use
+    Vector *freeHandles;
+
+    int (*cmp)(void *, void *);
+} IndexedPriorityQueue;
+
+#define INDEXED_PRIORITY_QUEUE_NONE ((size_t)-1)
+
+/* Construct an indexed priority queue with room for cap elements */
+IndexedPriorityQueue *__newIndexedPriorityQueueSize(size_t elemSize, size_t cap, int (*cmp)(void *, void *));
+
+#define NewIndexedPriorityQueue(type, cap, cmp) __newIndexedPriorityQueueSize(sizeof(type), cap, cmp)
+
+/* Return the number of elements in the queue */
+size_t Indexed_Priority_Queue_Size(IndexedPriorityQueue *pq);
+
+/* Insert element
+ * Inserts a copy of elem, and returns its handle.
+ */
+size_t __indexed_Priority_Queue_PushPtr(IndexedPriorityQueue *pq, void *elem);
+
+#define Indexed_Priority_Queue_Push(pq, elem) __indexed_Priority_Queue_PushPtr(pq, &(typeof(elem)){elem})
+
+/* Access top element
+ * Copy the top element to ptr and its handle to handle, if they are not NULL. Returns 0 if the queue is empty.
+ */
+int Indexed_Priority_Queue_Top(IndexedPriorityQueue *pq, void *ptr, size_t *handle);
+
+/* Remove top element
+ * Removes the top element, copying it to ptr if it is not NULL. Returns 0 if the queue is empty.
+ */
+int Indexed_Priority_Queue_Pop(IndexedPriorityQueue *pq, void *ptr);
+
+/* Return 1 if handle refers to an element in the queue */
+int Indexed_Priority_Queue_Contains(IndexedPriorityQueue *pq, size_t handle);
+
+/* Copy the element of handle to ptr. Returns 0 if handle is not in the queue */
+int Indexed_Priority_Queue_Get(IndexedPriorityQueue *pq, size_t handle, void *ptr);
+
+/* Update element
+ * Replaces the element of handle by elem, and moves it up or down the queue according to its new value. The handle
+ * stays the same. Returns 0 if handle is not in the queue.
+ */
+int __indexed_Priority_Queue_UpdateKeyPtr(IndexedPriorityQueue *pq, size_t handle, void *elem);
+
+#define Indexed_Priority_Queue_UpdateKey(pq, handle, elem)                                                           \
+    __indexed_Priority_Queue_UpdateKeyPtr(pq, handle, &(typeof(elem)){elem})
+
+/* Remove element
+ * Removes the element of handle from the queue, copying it to ptr if it is not NULL. Returns 0 if handle is not in
+ * the queue.
+ */
+int Indexed_Priority_Queue_Remove(IndexedPriorityQueue *pq, size_t handle, void *ptr);
+
+/* free the queue and the underlying data. Does not release its elements if they are pointers */
+void Indexed_Priority_Queue_Free(IndexedPriorityQueue *pq);
+
+#endif //__INDEXED_PRIORITY_QUEUE_H__
@@ -0,0 +1,141 @@
+#include "merge_iterator.h"
+
+#define SOURCE(it, i) ((MergeIteratorSource *)__vector_GetPtr((it)->sources, i))
+#define HEAD(it, i) ((it)->heads + (i) * (it)->elemSize)
+
+MergeIterator *__newMergeIteratorSize(size_t elemSize, int (*cmp)(void *, void *)) {
+    MergeIterator *it = malloc(sizeof(MergeIterator));
+    it->sources = NewVector(MergeIteratorSource, 4);
+    it->elemSize = elemSize;
+    it->cmp = cmp;
+    it->heads = NULL;
+    it->tree = NULL;
+    it->started = 0;
+    it->limit = 0;
+    it->emitted = 0;
+    return it;
+}
+
+static int __merge_iterator_add(MergeIterator *it, MergeIteratorNextFunc next, void *ctx, int ownsCtx) {
+    if (it->started)
+        return 0;
+    MergeIteratorSource src = {next, ctx, ownsCtx, 0};
+    __vector_PushPtr(it->sources, &src);
+    return 1;
+}
+
+int Merge_Iterator_AddSource(MergeIterator *it, MergeIteratorNextFunc next, void *ctx) {
+    return __merge_iterator_add(it, next, ctx, 0);
+}
+
+typedef struct {
+    Vector *v;
+    size_t pos;
+} vectorSource;
+
+static int __vector_source_next(void *ctx, void *elem) {
+    vectorSource *vs = ctx;
+    if (vs->pos >= vs->v->top)
+        return 0;
+    memcpy(elem, __vector_GetPtr(vs->v, vs->pos++), vs->v->elemSize);
+    return 1;
+}
+
+int Merge_Iterator_AddVector(MergeIterator *it, Vector *v) {
+    if (it->started || v->elemSize != it->elemSize)
+        return 0;
+    vectorSource *vs = malloc(sizeof(vectorSource));
+    vs->v = v;
+    vs->pos = 0;
+    return __merge_iterator_add(it, __vector_source_next, vs, 1);
+}
+
+void Merge_Iterator_SetLimit(MergeIterator *it, size_t limit) {
+    it->limit = limit;
+}
+
+/* Return 1 if the head of source a comes before the head of source b. Exhausted sources come last, and ties go to
+ * the source added first */
+static inline int __merge_before(MergeIterator *it, size_t a, size_t b) {
+    if (SOURCE(it, a)->done)
+        return 0;
+    if (SOURCE(it, b)->done)
+        return 1;
+    int c = it->cmp(HEAD(it, a), HEAD(it, b));
+    return c < 0 || (c == 0 && a < b);
+}
+
+static inline void __merge_fetch(MergeIterator *it, size_t i) {
+    MergeIteratorSource *src = SOURCE(it, i);
+    if (!src->done && !src->next(src->ctx, HEAD(it, i)))
+        src->done = 1;
+}
+
+/* Fetch the first element of every source and play the whole tournament. Leaves are at k..2k-1, and the inner nodes
+ * 1..k-1 have children 2n and 2n+1, which works for any k */
+static void __merge_start(MergeIterator *it) {
+    size_t k = it->sources->top;
+    it->started = 1;
+    if (k == 0)
+        return;
+
+    it->heads = malloc(k * it->elemSize);
+    it->tree = malloc(k * sizeof(size_t));
+    for (size_t i = 0; i < k; i++) {
+        __merge_fetch(it, i);
+    }
+
+    size_t *winners = malloc(2 * k * sizeof(size_t));
+    for (size_t i = 0; i < k; i++) {
+        winners[k + i] = i;
+    }
+    for (size_t node = k - 1; node >= 1; node--) {
+        size_t l = winners[2 * node], r = winners[2 * node + 1];
+        int leftWins = __merge_before(it, l, r);
+        winners[node] = leftWins ? l : r;
+        it->tree[node] = leftWins ? r : l;
+    }
+    it->tree[0] = k > 1 ? winners[1] : 0;
+    free(winners);
+}
+
+/* Replay the matches of source i, the last winner, from its leaf to the root */
+static void __merge_replay(MergeIterator *it, size_t i) {
+    size_t winner = i;
+    for (size_t node = (i + it->sources->top) / 2; node >= 1; node /= 2) {
+        if (__merge_before(it, it->tree[node], winner)) {
+            size_t loser = winner;
+            winner = it->tree[node];
+            it->tree[node] = loser;
+        }
+    }
+    it->tree[0] = winner;
+}
+
+int Merge_Iterator_Next(MergeIterator *it, void *elem) {
+    if (!it->started)
+        __merge_start(it);
+    if (it->sources->top == 0 || (it->limit && it->emitted >= it->limit))
+        return 0;
+
+    size_t winner = it->tree[0];
+    if (SOURCE(it, winner)->done)
+        return 0;
+    memcpy(elem, HEAD(it, winner), it->elemSize);
+    it->emitted++;
+
+    __merge_fetch(it, winner);
+    __merge_replay(it, winner);
+    return 1;
+}
+
+void Merge_Iterator_Free(MergeIterator *it) {
+    Vector_ForEach(it->sources, MergeIteratorSource, src) {
+        if (src->ownsCtx)
+            free(src->ctx);
+    }
+    Vector_Free(it->sources);
+    free(it->heads);
+    free(it->tree);
+    free(it);
+}
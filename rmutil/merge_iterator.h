@@ -0,0 +1,62 @@
+#ifndef __MERGE_ITERATOR_H__
+#define __MERGE_ITERATOR_H__
+
+#include "vector.h"
+
+/* K-way merge iterator
+ * Streams the elements of several sources, each sorted in ascending order of cmp, as one sorted sequence, without
+ * materializing their union. Only the current head of every source is held, and each element costs O(log k)
+ * comparisons for k sources.
+ * Sources are callbacks that copy their next element to elem and return 1, or return 0 once they are exhausted. They
+ * can wrap anything sorted, e.g. a Vector (see Merge_Iterator_AddVector) or a ZSET range walked with
+ * RedisModule_ZsetRangeNext.
+ * The sources are merged with a loser tree: a tournament whose inner nodes remember the loser of each match, so that
+ * replacing the winner only replays the matches on its path to the root, one comparison per level. Elements that
+ * compare equal come out in the order their sources were added.
+ */
+typedef int (*MergeIteratorNextFunc)(void *ctx, void *elem);
+
+typedef struct {
+    MergeIteratorNextFunc next;
+    void *ctx;
+    // free ctx with the iterator
+    int ownsCtx;
+    int done;
+} MergeIteratorSource;
+
+typedef struct {
+    Vector *sources;
+    size_t elemSize;
+    int (*cmp)(void *, void *);
+    // the current element of every source
+    char *heads;
+    // tree[0] is the source of the next element, tree[1..k) the losers of the inner matches
+    size_t *tree;
+    int started;
+    size_t limit;
+    size_t emitted;
+} MergeIterator;
+
+/* Construct a merge iterator of elements of elemSize, sorted by cmp */
+MergeIterator *__newMergeIteratorSize(size_t elemSize, int (*cmp)(void *, void *));
+
+#define NewMergeIterator(type, cmp) __newMergeIteratorSize(sizeof(type), cmp)
+
+/* Add a source, whose next callback will be called with ctx. Sources can only be added before the first call to
+ * Merge_Iterator_Next. Returns 0 if the iteration already started */
+int Merge_Iterator_AddSource(MergeIterator *it, MergeIteratorNextFunc next, void *ctx);
+
+/* Add the elements of v as a source. v must hold elements of the iterator's size, and must not change until the
+ * iteration is over. Returns 0 if the iteration already started or v has a different element size */
+int Merge_Iterator_AddVector(MergeIterator *it, Vector *v);
+
+/* Stop the iteration after limit elements. A limit of 0 means no limit */
+void Merge_Iterator_SetLimit(MergeIterator *it, size_t limit);
+
+/* Copy the next element in order to elem. Returns 0 once all sources are exhausted or the limit was reached */
+int Merge_Iterator_Next(MergeIterator *it, void *elem);
+
+/* free the iterator. Sources are not released, except for the Vector sources' bookkeeping */
+void Merge_Iterator_Free(MergeIterator *it);
+
+#endif //__MERGE_ITERATOR_H__
@@ -0,0 +1,141 @@
+#include "minmax_heap.h"
+
+/* Directions, for the functions shared by min and max levels */
+#define MIN_LEVEL 1
+#define MAX_LEVEL -1
+
+MinMaxHeap *__newMinMaxHeapSize(size_t elemSize, size_t cap, int (*cmp)(void *, void *)) {
+    MinMaxHeap *h = malloc(sizeof(MinMaxHeap));
+    h->v = __newVectorSizeFlags(elemSize, cap, VECTOR_NOZERO);
+    h->cmp = cmp;
+    return h;
+}
+
+inline size_t MinMax_Heap_Size(MinMaxHeap *h) {
+    return h->v->top;
+}
+
+/* Return MIN_LEVEL if i is on an even level of the tree, MAX_LEVEL otherwise */
+static inline int __mmh_level(size_t i) {
+    return ((63 - __builtin_clzll(i + 1)) & 1) ? MAX_LEVEL : MIN_LEVEL;
+}
+
+/* Return 1 if the element at a belongs above the element at b on a level of direction dir */
+static inline int __mmh_before(MinMaxHeap *h, size_t a, size_t b, int dir) {
+    void *x = __vector_GetPtr(h->v, a), *y = __vector_GetPtr(h->v, b);
+    return (dir == MIN_LEVEL ? h->cmp(x, y) : h->cmp(y, x)) < 0;
+}
+
+static inline void __mmh_swap(MinMaxHeap *h, size_t a, size_t b, char *tmp) {
+    memcpy(tmp, __vector_GetPtr(h->v, a), h->v->elemSize);
+    memcpy(__vector_GetPtr(h->v, a), __vector_GetPtr(h->v, b), h->v->elemSize);
+    memcpy(__vector_GetPtr(h->v, b), tmp, h->v->elemSize);
+}
+
+/* Move the element at i up through its grandparents, which are on levels of the same direction */
+static void __mmh_bubble_up_dir(MinMaxHeap *h, size_t i, int dir, char *tmp) {
+    while (i > 2) {
+        size_t grandparent = ((i - 1) / 2 - 1) / 2;
+        if (!__mmh_before(h, i, grandparent, dir))
+            break;
+        __mmh_swap(h, i, grandparent, tmp);
+        i = grandparent;
+    }
+}
+
+/* Move a new element at i up to its place. If it belongs on the other side of its parent it moves there first */
+static void __mmh_bubble_up(MinMaxHeap *h, size_t i, char *tmp) {
+    if (i == 0)
+        return;
+    int dir = __mmh_level(i);
+    size_t parent = (i - 1) / 2;
+    if (__mmh_before(h, parent, i, dir)) {
+        __mmh_swap(h, i, parent, tmp);
+        __mmh_bubble_up_dir(h, parent, -dir, tmp);
+    } else {
+        __mmh_bubble_up_dir(h, i, dir, tmp);
+    }
+}
+
+/* Move the element at i down to its place. On a min level it swaps with the smallest of its children and
+ * grandchildren, and on a max level with the greatest. Grandchildren are on the same kind of level, so it keeps going
+ * from there, after making sure it is on the right side of its new parent. */
+static void __mmh_trickle_down(MinMaxHeap *h, size_t i, char *tmp) {
+    size_t n = h->v->top;
+    int dir = __mmh_level(i);
+
+    while (2 * i + 1 < n) {
+        size_t best = 2 * i + 1;
+        size_t candidates[] = {2 * i + 2, 4 * i + 3, 4 * i + 4, 4 * i + 5, 4 * i + 6};
+        for (int c = 0; c < 5 && candidates[c] < n; c++) {
+            if (__mmh_before(h, candidates[c], best, dir))
+                best = candidates[c];
+        }
+        if (!__mmh_before(h, best, i, dir))
+            return;
+
+        __mmh_swap(h, best, i, tmp);
+        if (best <= 2 * i + 2)
+            return;
+
+        size_t parent = (best - 1) / 2;
+        if (__mmh_before(h, parent, best, dir))
+            __mmh_swap(h, best, parent, tmp);
+        i = best;
+    }
+}
+
+size_t __minMax_Heap_PushPtr(MinMaxHeap *h, void *elem) {
+    size_t top = __vector_PushPtr(h->v, elem);
+    char tmp[h->v->elemSize];
+    __mmh_bubble_up(h, top - 1, tmp);
+    return top;
+}
+
+/* Return the position of the greatest element of a non-empty heap */
+static inline size_t __mmh_max_pos(MinMaxHeap *h) {
+    if (h->v->top < 3)
+        return h->v->top - 1;
+    return __mmh_before(h, 1, 2, MAX_LEVEL) ? 1 : 2;
+}
+
+int MinMax_Heap_Min(MinMaxHeap *h, void *ptr) {
+    return Vector_Get(h->v, 0, ptr);
+}
+
+int MinMax_Heap_Max(MinMaxHeap *h, void *ptr) {
+    if (h->v->top == 0)
+        return 0;
+    return Vector_Get(h->v, __mmh_max_pos(h), ptr);
+}
+
+/* Remove the element at i, filling its place with the last element */
+static void __mmh_remove(MinMaxHeap *h, size_t i, void *ptr) {
+    if (ptr)
+        memcpy(ptr, __vector_GetPtr(h->v, i), h->v->elemSize);
+    size_t last = --h->v->top;
+    if (i < last) {
+        char tmp[h->v->elemSize];
+        memcpy(__vector_GetPtr(h->v, i), __vector_GetPtr(h->v, last), h->v->elemSize);
+        __mmh_trickle_down(h, i, tmp);
+    }
+}
+
+int MinMax_Heap_PopMin(MinMaxHeap *h, void *ptr) {
+    if (h->v->top == 0)
+        return 0;
+    __mmh_remove(h, 0, ptr);
+    return 1;
+}
+
+int MinMax_Heap_PopMax(MinMaxHeap *h, void *ptr) {
+    if (h->v->top == 0)
+        return 0;
+    __mmh_remove(h, __mmh_max_pos(h), ptr);
+    return 1;
+}
+
+void MinMax_Heap_Free(MinMaxHeap *h) {
+    Vector_Free(h->v);
+    free(h);
+}
@@ -0,0 +1,50 @@
+#ifndef __MINMAX_HEAP_H__
+#define __MINMAX_HEAP_H__
+
+#include "vector.h"
+
+/* Min-max heap
+ * A double-ended priority queue, giving access to both the smallest and the greatest of its elements according to
+ * cmp, in a single Vector. It replaces a pair of mirrored PriorityQueues for sliding window percentiles or bounded
+ * caches that evict from either end.
+ * The heap is a binary tree whose even levels are ordered as a min-heap and odd levels as a max-heap: the root is the
+ * smallest element, and the greatest is one of its two children. Min and Max are O(1), Push, PopMin and PopMax are
+ * O(log n).
+ */
+typedef struct {
+    Vector *v;
+
+    int (*cmp)(void *, void *);
+} MinMaxHeap;
+
+/* Construct a min-max heap with room for cap elements */
+MinMaxHeap *__newMinMaxHeapSize(size_t elemSize, size_t cap, int (*cmp)(void *, void *));
+
+#define NewMinMaxHeap(type, cap, cmp) __newMinMaxHeapSize(sizeof(type), cap, cmp)
+
+/* Return the number of elements in the heap */
+size_t MinMax_Heap_Size(MinMaxHeap *h);
+
+/* Insert element
+ * Inserts a copy of elem. Returns the new size of the heap.
+ */
+size_t __minMax_Heap_PushPtr(MinMaxHeap *h, void *elem);
+
+#define MinMax_Heap_Push(h, elem) __minMax_Heap_PushPtr(h, &(typeof(elem)){elem})
+
+/* Copy the smallest element to ptr. Returns 0 if the heap is empty */
+int MinMax_Heap_Min(MinMaxHeap *h, void *ptr);
+
+/* Copy the greatest element to ptr. Returns 0 if the heap is empty */
+int MinMax_Heap_Max(MinMaxHeap *h, void *ptr);
+
+/* Remove the smallest element, copying it to ptr if it is not NULL. Returns 0 if the heap is empty */
+int MinMax_Heap_PopMin(MinMaxHeap *h, void *ptr);
+
+/* Remove the greatest element, copying it to ptr if it is not NULL. Returns 0 if the heap is empty */
+int MinMax_Heap_PopMax(MinMaxHeap *h, void *ptr);
+
+/* free the heap and the underlying data. Does not release its elements if they are pointers */
+void MinMax_Heap_Free(MinMaxHeap *h);
+
+#endif //__MINMAX_HEAP_H__
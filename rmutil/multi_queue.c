@@ -0,0 +1,135 @@
+#include <stdint.h>
+#include "multi_queue.h"
+
+MultiQueue *__newMultiQueueSize(size_t elemSize, size_t numQueues, int (*cmp)(void *, void *)) {
+    MultiQueue *mq = malloc(sizeof(MultiQueue));
+    if (numQueues < 2)
+        numQueues = 2;
+    void *shards;
+    if (posix_memalign(&shards, sizeof(MultiQueueShard), numQueues * sizeof(MultiQueueShard))) {
+        free(mq);
+        return NULL;
+    }
+    mq->shards = shards;
+    mq->numQueues = numQueues;
+    mq->cmp = cmp;
+    for (size_t i = 0; i < numQueues; i++) {
+        pthread_mutex_init(&mq->shards[i].lock, NULL);
+        mq->shards[i].pq = __newPriorityQueueSize(elemSize, 0, cmp);
+        mq->shards[i].size = 0;
+    }
+    return mq;
+}
+
+/* Per thread xorshift generator, seeded from the address of its state, which differs between threads, unless
+ * Multi_Queue_SeedThread set it */
+static __thread uint64_t __mq_rng;
+
+void Multi_Queue_SeedThread(uint64_t seed) {
+    // xorshift has a fixed point at 0, which the lazy seeding below also takes as unset
+    __mq_rng = seed ? seed : 0x9E3779B97F4A7C15ULL;
+}
+
+static inline MultiQueueShard *__mq_random_shard(MultiQueue *mq) {
+    uint64_t x = __mq_rng;
+    if (!x)
+        x = (uintptr_t)&__mq_rng * 0x9E3779B97F4A7C15ULL | 1;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    __mq_rng = x;
+    // map the high bits to [0, numQueues) without a division
+    return &mq->shards[((x >> 32) * mq->numQueues) >> 32];
+}
+
+static inline size_t __mq_size(MultiQueueShard *s) {
+    return __atomic_load_n(&s->size, __ATOMIC_RELAXED);
+}
+
+static inline void __mq_update_size(MultiQueueShard *s) {
+    __atomic_store_n(&s->size, Priority_Queue_Size(s->pq), __ATOMIC_RELAXED);
+}
+
+size_t Multi_Queue_Size(MultiQueue *mq) {
+    size_t size = 0;
+    for (size_t i = 0; i < mq->numQueues; i++) {
+        size += __mq_size(&mq->shards[i]);
+    }
+    return size;
+}
+
+void __multi_Queue_PushPtr(MultiQueue *mq, void *elem) {
+    MultiQueueShard *s = __mq_random_shard(mq);
+    // try other queues while this one is busy, and only wait if they all seem to be
+    for (size_t attempt = 0; pthread_mutex_trylock(&s->lock); attempt++) {
+        s = __mq_random_shard(mq);
+        if (attempt == mq->numQueues) {
+            pthread_mutex_lock(&s->lock);
+            break;
+        }
+    }
+    __priority_Queue_PushPtr(s->pq, elem);
+    __mq_update_size(s);
+    pthread_mutex_unlock(&s->lock);
+}
+
+/* Pop the top of a locked, non-empty queue and unlock it */
+static void __mq_pop_locked(MultiQueueShard *s, void *ptr) {
+    Priority_Queue_Top(s->pq, ptr);
+    Priority_Queue_Pop(s->pq);
+    __mq_update_size(s);
+    pthread_mutex_unlock(&s->lock);
+}
+
+int Multi_Queue_Pop(MultiQueue *mq, void *ptr) {
+    for (size_t attempt = 0; attempt < 2 * mq->numQueues; attempt++) {
+        MultiQueueShard *a = __mq_random_shard(mq), *b = __mq_random_shard(mq);
+        if (a == b || (!__mq_size(a) && !__mq_size(b)))
+            continue;
+
+        int lockedA = !pthread_mutex_trylock(&a->lock);
+        int lockedB = !pthread_mutex_trylock(&b->lock);
+        if (lockedA && lockedB) {
+            // keep the queue with the higher top, an empty queue loses
+            MultiQueueShard *loser = b;
+            if (!Priority_Queue_Size(a->pq) ||
+                (Priority_Queue_Size(b->pq) &&
+                 mq->cmp(__vector_GetPtr(a->pq->v, 0), __vector_GetPtr(b->pq->v, 0)) < 0)) {
+                loser = a;
+                a = b;
+            }
+            pthread_mutex_unlock(&loser->lock);
+        } else if (lockedB) {
+            a = b;
+        } else if (!lockedA) {
+            continue;
+        }
+
+        if (Priority_Queue_Size(a->pq)) {
+            __mq_pop_locked(a, ptr);
+            return 1;
+        }
+        pthread_mutex_unlock(&a->lock);
+    }
+
+    // the queues look empty or busy, check them all before giving up
+    for (size_t i = 0; i < mq->numQueues; i++) {
+        MultiQueueShard *s = &mq->shards[i];
+        pthread_mutex_lock(&s->lock);
+        if (Priority_Queue_Size(s->pq)) {
+            __mq_pop_locked(s, ptr);
+            return 1;
+        }
+        pthread_mutex_unlock(&s->lock);
+    }
+    return 0;
+}
+
+void Multi_Queue_Free(MultiQueue *mq) {
+    for (size_t i = 0; i < mq->numQueues; i++) {
+        pthread_mutex_destroy(&mq->shards[i].lock);
+        Priority_Queue_Free(mq->shards[i].pq);
+    }
+    free(mq->shards);
+    free(mq);
+}
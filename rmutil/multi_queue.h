@@ -0,0 +1,60 @@
+#ifndef __MULTI_QUEUE_H__
+#define __MULTI_QUEUE_H__
+
+#include <pthread.h>
+#include <stdint.h>
+#include "priority_queue.h"
+
+/* Concurrent relaxed priority queue (MultiQueue)
+ * A priority queue shared by several threads, made of numQueues PriorityQueues with a lock each, so that threads
+ * rarely wait on each other. Use a few queues per thread, e.g. 2 to 4 times the number of threads.
+ * Push inserts into a random queue. Pop looks at two random queues and pops from the one whose top compares higher.
+ * Locks are only tried, and a busy queue is swapped for another random one, so no thread blocks while others hold
+ * locks, except when the whole structure looks empty.
+ * The order is relaxed: Pop returns an element close to the top, not necessarily the top one. On average, the rank of
+ * the element it returns is O(numQueues). Pop only returns 0 if every queue was empty when it checked.
+ */
+
+/* A queue and its lock, padded to a cache line so that threads working on different queues do not share lines */
+typedef struct {
+    pthread_mutex_t lock;
+    PriorityQueue *pq;
+    // size of pq, readable without the lock
+    size_t size;
+} __attribute__((aligned(64))) MultiQueueShard;
+
+typedef struct {
+    MultiQueueShard *shards;
+    size_t numQueues;
+
+    int (*cmp)(void *, void *);
+} MultiQueue;
+
+/* Construct a multi queue of numQueues priority queues, at least 2 */
+MultiQueue *__newMultiQueueSize(size_t elemSize, size_t numQueues, int (*cmp)(void *, void *));
+
+#define NewMultiQueue(type, numQueues, cmp) __newMultiQueueSize(sizeof(type), numQueues, cmp)
+
+/* Return the number of elements. With concurrent pushes and pops it is only a snapshot */
+size_t Multi_Queue_Size(MultiQueue *mq);
+
+/* Insert element
+ * Inserts a copy of elem into one of the queues.
+ */
+void __multi_Queue_PushPtr(MultiQueue *mq, void *elem);
+
+#define Multi_Queue_Push(mq, elem) __multi_Queue_PushPtr(mq, &(typeof(elem)){elem})
+
+/* Remove a top element
+ * Removes an element close to the top and copies it to ptr. Returns 0 if the queue is empty.
+ */
+int Multi_Queue_Pop(MultiQueue *mq, void *ptr);
+
+/* Seed the random choices of the calling thread, for all multi queues, e.g. to make a test reproducible. Threads that
+ * do not call it are seeded from the address of their state, which varies between runs */
+void Multi_Queue_SeedThread(uint64_t seed);
+
+/* free the queue and the underlying data. No thread may be using it */
+void Multi_Queue_Free(MultiQueue *mq);
+
+#endif //__MULTI_QUEUE_H__
@@ -0,0 +1,24 @@
+#ifndef __RMUTIL_PARSE_H__
+#define __RMUTIL_PARSE_H__
+
+#include <stddef.h>
+
+/* Number parsing
+ * Strict string to number conversion with the same rules as RedisModule_StringToLongLong and
+ * RedisModule_StringToDouble, without calling into the module API. Digits are converted eight at a time with SWAR
+ * arithmetic on 64 bit words. Doubles with up to 19 significant digits are converted exactly with Clinger's fast path
+ * or the Eisel-Lemire algorithm, and everything else falls back to strtod().
+ *
+ * The functions take the string and its length, and do not need a NULL terminator. They return 1 and set *value if
+ * the whole string is a valid number, or 0 and leave *value unchanged otherwise.
+ */
+
+/* Parse a decimal long long, like Redis string2ll(): an optional '-' followed by digits, no '+', no leading zeros
+ * except for "0" itself, no spaces, and no overflow */
+int RMUtil_ParseLongLong(const char *s, size_t len, long long *value);
+
+/* Parse a double, like Redis does with strtod(): anything strtod() accepts in full, including inf and hexadecimal
+ * notation, but not NaN, leading spaces, or values that overflow to infinity or underflow to 0 */
+int RMUtil_ParseDouble(const char *s, size_t len, double *value);
+
+#endif //__RMUTIL_PARSE_H__
@@ -2,9 +2,14 @@
 #include "heap.h"
 
 PriorityQueue *__newPriorityQueueSize(size_t elemSize, size_t cap, int (*cmp)(void *, void *)) {
+    return __newPriorityQueueSizeArity(elemSize, cap, cmp, 2);
+}
+
+PriorityQueue *__newPriorityQueueSizeArity(size_t elemSize, size_t cap, int (*cmp)(void *, void *), int arity) {
     PriorityQueue *pq = malloc(sizeof(PriorityQueue));
     pq->v = __newVectorSize(elemSize, cap);
     pq->cmp = cmp;
+    pq->arity = arity < 2 ? 2 : arity;
     return pq;
 }
 
@@ -18,15 +23,42 @@ inline int Priority_Queue_Top(PriorityQueue *pq, void *ptr) {
 
 inline size_t __priority_Queue_PushPtr(PriorityQueue *pq, void *elem) {
     size_t top = __vector_PushPtr(pq->v, elem);
-    Heap_Push(pq->v, 0, top, pq->cmp);
+    Heap_Push_Arity(pq->v, 0, top, pq->cmp, pq->arity);
     return top;
 }
 
+size_t Priority_Queue_PushMany(PriorityQueue *pq, void *elems, size_t n) {
+    size_t old = pq->v->top;
+    Vector_PushMany(pq->v, elems, n);
+    size_t top = pq->v->top;
+
+    // n sift-ups cost up to n * log2(top) comparisons, a rebuild about 2 * top
+    size_t depth = 0;
+    while ((top >> depth) > 1)
+        depth++;
+    if (n * depth > 2 * top) {
+        Make_Heap_Arity(pq->v, 0, top, pq->cmp, pq->arity);
+    } else {
+        for (size_t last = old + 1; last <= top; last++) {
+            Heap_Push_Arity(pq->v, 0, last, pq->cmp, pq->arity);
+        }
+    }
+    return top;
+}
+
+int Priority_Queue_Merge(PriorityQueue *dst, PriorityQueue *src) {
+    if (dst->v->elemSize != src->v->elemSize)
+        return 0;
+    // when src is dst, PushMany copies from the vector's own data after growing it
+    Priority_Queue_PushMany(dst, src->v->data, src->v->top);
+    return 1;
+}
+
 inline void Priority_Queue_Pop(PriorityQueue *pq) {
     if (pq->v->top == 0) {
         return;
     }
-    Heap_Pop(pq->v, 0, pq->v->top, pq->cmp);
+    Heap_Pop_Arity(pq->v, 0, pq->v->top, pq->cmp, pq->arity);
     pq->v->top--;
 }
 
@@ -14,6 +14,9 @@ typedef struct {
     Vector *v;
 
     int (*cmp)(void *, void *);
+
+    // number of children of each node in the underlying heap
+    int arity;
 } PriorityQueue;
 
 /* Construct priority queue
@@ -23,6 +26,14 @@ PriorityQueue *__newPriorityQueueSize(size_t elemSize, size_t cap, int (*cmp)(vo
 
 #define NewPriorityQueue(type, cap, cmp) __newPriorityQueueSize(sizeof(type), cap, cmp)
 
+/* Construct priority queue on a d-ary heap
+ * Same as NewPriorityQueue, but each node of the heap has arity children (see Make_Heap_Arity). An arity of 4 makes
+ * pushes and pops cheaper on queues with many elements.
+ */
+PriorityQueue *__newPriorityQueueSizeArity(size_t elemSize, size_t cap, int (*cmp)(void *, void *), int arity);
+
+#define NewPriorityQueueArity(type, cap, cmp, arity) __newPriorityQueueSizeArity(sizeof(type), cap, cmp, arity)
+
 /* Return size
  * Returns the number of elements in the priority_queue.
  */
@@ -41,6 +52,19 @@ size_t __priority_Queue_PushPtr(PriorityQueue *pq, void *elem);
 
 #define Priority_Queue_Push(pq, elem) __priority_Queue_PushPtr(pq, &(typeof(elem)){elem})
 
+/* Insert elements
+ * Inserts the n elements of the array elems. When the batch is large compared to the queue, they are appended and the
+ * heap is rebuilt with Make_Heap in O(size + n), otherwise they are sifted up one by one.
+ * Returns the new size of the queue.
+ */
+size_t Priority_Queue_PushMany(PriorityQueue *pq, void *elems, size_t n);
+
+/* Merge queues
+ * Inserts copies of all the elements of src into dst, leaving src unchanged. src may be dst, which duplicates every
+ * element. Returns 0 if the queues do not hold elements of the same size.
+ */
+int Priority_Queue_Merge(PriorityQueue *dst, PriorityQueue *src);
+
 /* Remove top element
  * Removes the element on top of the priority_queue, effectively reducing its size by one. The element removed is the
  * one with the highest value.
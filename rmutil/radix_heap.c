@@ -0,0 +1,103 @@
+#include "radix_heap.h"
+
+/* Entries are a key followed by the payload, padded so that keys stay aligned */
+#define ENTRY_SIZE(rh) (sizeof(uint64_t) + (((rh)->payloadSize + 7) & ~(size_t)7))
+#define ENTRY_PAYLOAD(e) ((char *)(e) + sizeof(uint64_t))
+
+/* Keys in the buckets are read through memcpy, which compiles to a plain load, since entries are raw bytes */
+static inline uint64_t __entry_key(const void *entry) {
+    uint64_t key;
+    memcpy(&key, entry, sizeof(key));
+    return key;
+}
+
+RadixHeap *__newRadixHeapSize(size_t payloadSize) {
+    RadixHeap *rh = malloc(sizeof(RadixHeap));
+    rh->payloadSize = payloadSize;
+    for (int i = 0; i < RADIX_HEAP_BUCKETS; i++) {
+        rh->buckets[i] = __newVectorSizeFlags(ENTRY_SIZE(rh), 0, VECTOR_NOZERO);
+    }
+    rh->nonEmpty = 0;
+    rh->last = 0;
+    rh->size = 0;
+    return rh;
+}
+
+inline size_t Radix_Heap_Size(RadixHeap *rh) {
+    return rh->size;
+}
+
+/* Return the bucket of key: 0 if it equals the last key, or 1 + the highest bit in which they differ */
+static inline int __radix_heap_bucket(RadixHeap *rh, uint64_t key) {
+    return key == rh->last ? 0 : 64 - __builtin_clzll(key ^ rh->last);
+}
+
+static inline void __radix_heap_add(RadixHeap *rh, int bucket, void *entry) {
+    __vector_PushPtr(rh->buckets[bucket], entry);
+    if (bucket)
+        rh->nonEmpty |= 1ULL << (bucket - 1);
+}
+
+int __radix_Heap_PushPtr(RadixHeap *rh, uint64_t key, void *payload) {
+    if (key < rh->last)
+        return 0;
+
+    uint64_t entry[ENTRY_SIZE(rh) / sizeof(uint64_t)];
+    entry[0] = key;
+    if (payload)
+        memcpy(ENTRY_PAYLOAD(entry), payload, rh->payloadSize);
+    __radix_heap_add(rh, __radix_heap_bucket(rh, key), entry);
+    rh->size++;
+    return 1;
+}
+
+/* Make sure bucket 0 holds the smallest entries, if the heap is not empty.
+ * The smallest key is in the lowest non-empty bucket. It becomes the new last key, and the bucket is emptied into
+ * lower buckets: its keys share all bits above the bucket with the new last key, so they all land below it. */
+static void __radix_heap_refill(RadixHeap *rh) {
+    if (rh->buckets[0]->top || !rh->nonEmpty)
+        return;
+
+    int bucket = __builtin_ctzll(rh->nonEmpty) + 1;
+    Vector *v = rh->buckets[bucket];
+    uint64_t min = UINT64_MAX;
+    for (size_t i = 0; i < v->top; i++) {
+        uint64_t key = __entry_key(__vector_GetPtr(v, i));
+        min = key < min ? key : min;
+    }
+    rh->last = min;
+
+    for (size_t i = 0; i < v->top; i++) {
+        char *entry = __vector_GetPtr(v, i);
+        __radix_heap_add(rh, __radix_heap_bucket(rh, __entry_key(entry)), entry);
+    }
+    v->top = 0;
+    rh->nonEmpty &= ~(1ULL << (bucket - 1));
+}
+
+int Radix_Heap_Top(RadixHeap *rh, uint64_t *key, void *payload) {
+    if (rh->size == 0)
+        return 0;
+    __radix_heap_refill(rh);
+    char *entry = __vector_GetPtr(rh->buckets[0], rh->buckets[0]->top - 1);
+    if (key)
+        *key = __entry_key(entry);
+    if (payload)
+        memcpy(payload, ENTRY_PAYLOAD(entry), rh->payloadSize);
+    return 1;
+}
+
+int Radix_Heap_Pop(RadixHeap *rh, uint64_t *key, void *payload) {
+    if (!Radix_Heap_Top(rh, key, payload))
+        return 0;
+    rh->buckets[0]->top--;
+    rh->size--;
+    return 1;
+}
+
+void Radix_Heap_Free(RadixHeap *rh) {
+    for (int i = 0; i < RADIX_HEAP_BUCKETS; i++) {
+        Vector_Free(rh->buckets[i]);
+    }
+    free(rh);
+}
@@ -0,0 +1,58 @@
+#ifndef __RADIX_HEAP_H__
+#define __RADIX_HEAP_H__
+
+#include <stdint.h>
+#include "vector.h"
+
+/* Radix heap
+ * A monotone min priority queue with uint64_t keys, each carrying a fixed size payload. Monotone means that a key
+ * pushed must not be smaller than the last key returned by Top or Pop, which holds for timestamps, deadlines and
+ * Dijkstra-style distances. Its top is the entry with the smallest key.
+ * Entries are kept in 65 buckets, by the highest bit in which their key differs from that last key. Pushes
+ * append to a bucket in O(1). When the lowest bucket runs empty, the next non-empty bucket is redistributed into lower
+ * buckets, so each entry moves at most 64 times and pops take amortized O(log C), where C is the range of the keys,
+ * without any comparisons between entries.
+ */
+#define RADIX_HEAP_BUCKETS 65
+
+typedef struct {
+    Vector *buckets[RADIX_HEAP_BUCKETS];
+    // bit i - 1 is set if bucket i is not empty, bucket 0 is checked directly
+    uint64_t nonEmpty;
+    // the last key returned by Top or Pop
+    uint64_t last;
+    size_t size;
+    size_t payloadSize;
+} RadixHeap;
+
+/* Create a new radix heap whose entries carry a payload of payloadSize bytes, which may be 0 */
+RadixHeap *__newRadixHeapSize(size_t payloadSize);
+
+#define NewRadixHeap(type) __newRadixHeapSize(sizeof(type))
+
+/* Return the number of entries in the heap */
+size_t Radix_Heap_Size(RadixHeap *rh);
+
+/* Insert entry
+ * Inserts key with a copy of the payload, which may be NULL if the heap has no payload. Returns 0, without inserting
+ * anything, if key is smaller than the last key returned by Top or Pop.
+ */
+int __radix_Heap_PushPtr(RadixHeap *rh, uint64_t key, void *payload);
+
+#define Radix_Heap_Push(rh, key, payload) __radix_Heap_PushPtr(rh, key, &(typeof(payload)){payload})
+
+/* Access top entry
+ * Copies the smallest key to key and its payload to payload, if they are not NULL. Returns 0 if the heap is empty.
+ */
+int Radix_Heap_Top(RadixHeap *rh, uint64_t *key, void *payload);
+
+/* Remove top entry
+ * Removes the entry with the smallest key, copying it to key and payload if they are not NULL. Returns 0 if the heap
+ * is empty.
+ */
+int Radix_Heap_Pop(RadixHeap *rh, uint64_t *key, void *payload);
+
+/* free the heap and the underlying data. Does not release payloads if they are pointers */
+void Radix_Heap_Free(RadixHeap *rh);
+
+#endif //__RADIX_HEAP_H__
@@ -37,6 +37,8 @@
 #include <assert.h>
 #include "sds.h"
 #include "sdsalloc.h"
+#include "bytes.h"
+#include "format.h"
 
 static inline int sdsHdrSize(char type) {
     switch(type&SDS_TYPE_MASK) {
@@ -424,66 +426,16 @@ sds sdscpy(sds s, const char *t) {
  * SDS_LLSTR_SIZE bytes.
  *
  * The function returns the length of the null-terminated string
- * representation stored at 's'. */
-#define SDS_LLSTR_SIZE 21
+ * representation stored at 's'. The digits are generated two at a
+ * time, see format.h. */
+#define SDS_LLSTR_SIZE RMUTIL_FMT_INT_SIZE
 int sdsll2str(char *s, long long value) {
-    char *p, aux;
-    unsigned long long v;
-    size_t l;
-
-    /* Generate the string representation, this method produces
-     * an reversed string. */
-    v = (value < 0) ? -value : value;
-    p = s;
-    do {
-        *p++ = '0'+(v%10);
-        v /= 10;
-    } while(v);
-    if (value < 0) *p++ = '-';
-
-    /* Compute length and add null term. */
-    l = p-s;
-    *p = '\0';
-
-    /* Reverse the string. */
-    p--;
-    while(s < p) {
-        aux = *s;
-        *s = *p;
-        *p = aux;
-        s++;
-        p--;
-    }
-    return l;
+    return RMUtil_FormatI64(s,value);
 }
 
 /* Identical sdsll2str(), but for unsigned long long type. */
 int sdsull2str(char *s, unsigned long long v) {
-    char *p, aux;
-    size_t l;
-
-    /* Generate the string representation, this method produces
-     * an reversed string. */
-    p = s;
-    do {
-        *p++ = '0'+(v%10);
-        v /= 10;
-    } while(v);
-
-    /* Compute length and add null term. */
-    l = p-s;
-    *p = '\0';
-
-    /* Reverse the string. */
-    p--;
-    while(s < p) {
-        aux = *s;
-        *s = *p;
-        *p = aux;
-        s++;
-        p--;
-    }
-    return l;
+    return RMUtil_FormatU64(s,v);
 }
 
 /* Create an sds string from a long long value. It is much faster than:
@@ -501,36 +453,30 @@ sds sdsfromlonglong(long long value) {
 sds sdscatvprintf(sds s, const char *fmt, va_list ap) {
     va_list cpy;
     char staticbuf[1024], *buf = staticbuf, *t;
-    size_t buflen = strlen(fmt)*2;
-
-    /* We try to start using a static buffer for speed.
-     * If not possible we revert to heap allocation. */
-    if (buflen > sizeof(staticbuf)) {
-        buf = s_malloc(buflen);
+    int len;
+
+    /* We try to start using a static buffer for speed. If the string
+     * does not fit, vsnprintf() still returns its full length, so a
+     * heap buffer of the exact size is formatted once more.
+     *
+     * The arguments may point into 's' itself, so the string is not
+     * formatted directly into its free space. */
+    va_copy(cpy,ap);
+    len = vsnprintf(buf, sizeof(staticbuf), fmt, cpy);
+    va_end(cpy);
+    /* On an encoding error there is nothing to append, and callers of the
+     * s = sdscatprintf(s,...) form expect s back rather than NULL. */
+    if (len < 0) return s;
+    if ((size_t)len >= sizeof(staticbuf)) {
+        buf = s_malloc(len+1);
         if (buf == NULL) return NULL;
-    } else {
-        buflen = sizeof(staticbuf);
-    }
-
-    /* Try with buffers two times bigger every time we fail to
-     * fit the string in the current buffer size. */
-    while(1) {
-        buf[buflen-2] = '\0';
         va_copy(cpy,ap);
-        vsnprintf(buf, buflen, fmt, cpy);
+        vsnprintf(buf, len+1, fmt, cpy);
         va_end(cpy);
-        if (buf[buflen-2] != '\0') {
-            if (buf != staticbuf) s_free(buf);
-            buflen *= 2;
-            buf = s_malloc(buflen);
-            if (buf == NULL) return NULL;
-            continue;
-        }
-        break;
     }
 
     /* Finally concat the obtained string to the SDS string and return it. */
-    t = sdscat(s, buf);
+    t = sdscatlen(s, buf, len);
     if (buf != staticbuf) s_free(buf);
     return t;
 }
@@ -574,7 +520,13 @@ sds sdscatprintf(sds s, const char *fmt, ...) {
  * %I - 64 bit signed integer (long long, int64_t)
  * %u - unsigned int
  * %U - 64 bit unsigned integer (unsigned long long, uint64_t)
+ * %g - double, with the shortest digits that read back as the same
+ *      double, in exponent notation for very large or small values
+ * %f - double, with the shortest digits, never in exponent notation
  * %% - Verbatim "%" character.
+ *
+ * Numbers are formatted with the functions of format.h, so no specifier
+ * calls the printf family.
  */
 sds sdscatfmt(sds s, char const *fmt, ...) {
     size_t initlen = sdslen(s);
@@ -646,6 +598,23 @@ sds sdscatfmt(sds s, char const *fmt, ...) {
                     i += l;
                 }
                 break;
+            case 'g':
+            case 'f':
+                {
+                    char buf[RMUTIL_FMT_DOUBLE_FIXED_SIZE];
+                    double d = va_arg(ap,double);
+                    if (next == 'g')
+                        l = RMUtil_FormatDouble(buf,d);
+                    else
+                        l = RMUtil_FormatDoubleFixed(buf,d);
+                    if (sdsavail(s) < l) {
+                        s = sdsMakeRoomFor(s,l);
+                    }
+                    memcpy(s+i,buf,l);
+                    sdsinclen(s,l);
+                    i += l;
+                }
+                break;
             default: /* Handle %% and generally %<unknown>. */
                 s[i++] = next;
                 sdsinclen(s,1);
@@ -739,18 +708,16 @@ void sdsrange(sds s, int start, int end) {
     sdssetlen(s,newlen);
 }
 
-/* Apply tolower() to every character of the sds string 's'. */
+/* Apply tolower() to every character of the sds string 's', as in the
+ * C locale: only the ASCII letters are converted. */
 void sdstolower(sds s) {
-    int len = sdslen(s), j;
-
-    for (j = 0; j < len; j++) s[j] = tolower(s[j]);
+    RMUtil_ASCIIToLower(s,sdslen(s));
 }
 
-/* Apply toupper() to every character of the sds string 's'. */
+/* Apply toupper() to every character of the sds string 's', as in the
+ * C locale: only the ASCII letters are converted. */
 void sdstoupper(sds s) {
-    int len = sdslen(s), j;
-
-    for (j = 0; j < len; j++) s[j] = toupper(s[j]);
+    RMUtil_ASCIIToUpper(s,sdslen(s));
 }
 
 /* Compare two sds strings s1 and s2 with memcmp().
@@ -776,6 +743,59 @@ int sdscmp(const sds s1, const sds s2) {
     return cmp;
 }
 
+/* Initialize 'it' to iterate the tokens of 's' split by the separator
+ * 'sep', without copying them. The tokens are the same ones sdssplitlen()
+ * returns: a zero length string has no tokens, and otherwise there is one
+ * more token than there are separators, so empty tokens are reported.
+ *
+ * The iterator holds pointers to 's' and 'sep', which must stay valid and
+ * unmodified while it is in use. A zero length separator yields no tokens. */
+void sdssplitinit(sdssplititer *it, const char *s, size_t len, const char *sep, size_t seplen) {
+    it->p = s;
+    it->end = s+len;
+    it->sep = sep;
+    it->seplen = seplen;
+    it->done = (len == 0 || seplen == 0);
+}
+
+/* Store the next token of the iterator in 'tok' as a pointer into the
+ * original string and a length. The token is not null terminated.
+ * Returns 1 if a token was stored, 0 once all the tokens were returned. */
+int sdssplitnext(sdssplititer *it, sdsslice *tok) {
+    const char *sep;
+
+    if (it->done) return 0;
+    sep = RMUtil_FindSep(it->p,it->end-it->p,it->sep,it->seplen);
+    tok->ptr = it->p;
+    if (sep == NULL) {
+        tok->len = it->end-it->p;
+        it->done = 1;
+    } else {
+        tok->len = sep-it->p;
+        it->p = sep+it->seplen;
+    }
+    return 1;
+}
+
+/* Call 'cb' for every token of 's' split by the separator 'sep', in order,
+ * with a pointer into 's' and the length of the token. Nothing is
+ * allocated or copied. If the callback returns 0 the split stops early.
+ *
+ * Returns the number of tokens passed to the callback. */
+size_t sdssplitcb(const char *s, size_t len, const char *sep, size_t seplen,
+                  sdssplitfunc *cb, void *ctx) {
+    sdssplititer it;
+    sdsslice tok;
+    size_t count = 0;
+
+    sdssplitinit(&it,s,len,sep,seplen);
+    while (sdssplitnext(&it,&tok)) {
+        count++;
+        if (!cb(ctx,tok.ptr,tok.len)) break;
+    }
+    return count;
+}
+
 /* Split 's' with separator in 'sep'. An array
  * of sds strings is returned. *count will be set
  * by reference to the number of tokens returned.
@@ -791,43 +811,34 @@ int sdscmp(const sds s1, const sds s2) {
  * This version of the function is binary-safe but
  * requires length arguments. sdssplit() is just the
  * same function but for zero-terminated strings.
+ *
+ * Every token is copied to a new sds string. Use
+ * sdssplitinit()/sdssplitnext() or sdssplitcb() to
+ * visit the tokens in place instead.
  */
 sds *sdssplitlen(const char *s, int len, const char *sep, int seplen, int *count) {
-    int elements = 0, slots = 5, start = 0, j;
+    int elements = 0, slots = 1;
+    const char *p, *end;
+    sdssplititer it;
+    sdsslice tok;
     sds *tokens;
 
     if (seplen < 1 || len < 0) return NULL;
 
+    /* Count the separators first, so the tokens array is allocated once */
+    end = s+len;
+    for (p = s; len && (p = RMUtil_FindSep(p,end-p,sep,seplen)) != NULL; p += seplen)
+        slots++;
+
     tokens = s_malloc(sizeof(sds)*slots);
     if (tokens == NULL) return NULL;
 
-    if (len == 0) {
-        *count = 0;
-        return tokens;
-    }
-    for (j = 0; j < (len-(seplen-1)); j++) {
-        /* make sure there is room for the next element and the final one */
-        if (slots < elements+2) {
-            sds *newtokens;
-
-            slots *= 2;
-            newtokens = s_realloc(tokens,sizeof(sds)*slots);
-            if (newtokens == NULL) goto cleanup;
-            tokens = newtokens;
-        }
-        /* search the separator */
-        if ((seplen == 1 && *(s+j) == sep[0]) || (memcmp(s+j,sep,seplen) == 0)) {
-            tokens[elements] = sdsnewlen(s+start,j-start);
-            if (tokens[elements] == NULL) goto cleanup;
-            elements++;
-            start = j+seplen;
-            j = j+seplen-1; /* skip the separator */
-        }
+    sdssplitinit(&it,s,len,sep,seplen);
+    while (sdssplitnext(&it,&tok)) {
+        tokens[elements] = sdsnewlen(tok.ptr,tok.len);
+        if (tokens[elements] == NULL) goto cleanup;
+        elements++;
     }
-    /* Add the final element. We are sure there is room in the tokens array. */
-    tokens[elements] = sdsnewlen(s+start,len-start);
-    if (tokens[elements] == NULL) goto cleanup;
-    elements++;
     *count = elements;
     return tokens;
 
@@ -214,6 +214,25 @@ static inline void sdssetalloc(sds s, size_t newlen) {
     }
 }
 
+/* A view of part of a string, as returned by the zero-copy split functions.
+ * It points into the original string and is not null terminated. */
+typedef struct sdsslice {
+    const char *ptr;
+    size_t len;
+} sdsslice;
+
+/* State of a zero-copy split, see sdssplitinit() */
+typedef struct sdssplititer {
+    const char *p;
+    const char *end;
+    const char *sep;
+    size_t seplen;
+    int done;
+} sdssplititer;
+
+/* Callback of sdssplitcb(), return 0 to stop the split */
+typedef int sdssplitfunc(void *ctx, const char *tok, size_t len);
+
 sds sdsnewlen(const void *init, size_t initlen);
 sds sdsnew(const char *init);
 sds sdsempty(void);
@@ -241,6 +260,10 @@ void sdsupdatelen(sds s);
 void sdsclear(sds s);
 int sdscmp(const sds s1, const sds s2);
 sds *sdssplitlen(const char *s, int len, const char *sep, int seplen, int *count);
+void sdssplitinit(sdssplititer *it, const char *s, size_t len, const char *sep, size_t seplen);
+int sdssplitnext(sdssplititer *it, sdsslice *tok);
+size_t sdssplitcb(const char *s, size_t len, const char *sep, size_t seplen,
+                  sdssplitfunc *cb, void *ctx);
 void sdsfreesplitres(sds *tokens, int count);
 void sdstolower(sds s);
 void sdstoupper(sds s);
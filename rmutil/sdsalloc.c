@@ -0,0 +1,167 @@
+/* Runtime selection of the SDS allocator, and the libc and arena
+ * allocators. See sdsalloc.h. */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sdsalloc.h"
+
+static void *libcMalloc(void *ctx, size_t size) { return malloc(size); }
+static void *libcRealloc(void *ctx, void *ptr, size_t size) { return realloc(ptr,size); }
+static void libcFree(void *ctx, void *ptr) { free(ptr); }
+
+const sdsAllocator sdsLibcAllocator = {libcMalloc, libcRealloc, libcFree, NULL};
+
+const sdsAllocator *__sdsProcessAllocator = &sdsLibcAllocator;
+__thread const sdsAllocator *__sdsThreadAllocator;
+
+void sdsSetAllocator(const sdsAllocator *a) {
+    __sdsProcessAllocator = a ? a : &sdsLibcAllocator;
+}
+
+const sdsAllocator *sdsUseAllocator(const sdsAllocator *a) {
+    const sdsAllocator *prev = __sdsThreadAllocator;
+    __sdsThreadAllocator = a;
+    return prev;
+}
+
+/* ------------------------------ Arena ------------------------------------ */
+
+#define ARENA_ALIGN 8
+#define ARENA_ROUND(n) (((n)+ARENA_ALIGN-1) & ~(size_t)(ARENA_ALIGN-1))
+
+/* Every allocation is preceded by its size, so that realloc() knows how
+ * much to copy. */
+typedef struct arenaHeader {
+    size_t size;
+} arenaHeader;
+
+typedef struct arenaChunk {
+    struct arenaChunk *next;
+    size_t size;    /* Usable bytes after the header. */
+    char data[];
+} __attribute__((aligned(ARENA_ALIGN))) arenaChunk;
+
+/* Largest allocation size whose rounding, header and chunk header cannot
+ * overflow a size_t. */
+#define ARENA_MAX_ALLOC \
+    (SIZE_MAX-sizeof(arenaChunk)-sizeof(arenaHeader)-ARENA_ALIGN)
+
+struct sdsArena {
+    sdsAllocator allocator;     /* Allocates from this arena. */
+    const sdsAllocator *parent; /* Allocates the chunks. */
+    size_t chunkSize;
+    arenaChunk *chunks;         /* The current chunk is the first one. */
+    char *cur;                  /* Next free byte of the current chunk. */
+    char *end;                  /* End of the current chunk. */
+    char *last;                 /* Most recent allocation, or NULL. */
+};
+
+/* Add a chunk with room for 'needed' bytes, header included, and make it
+ * the current one. */
+static int arenaAddChunk(sdsArena *arena, size_t needed) {
+    size_t chunkSize = arena->chunkSize;
+    if (needed > chunkSize) chunkSize = needed;
+    arenaChunk *c = arena->parent->mallocFn(arena->parent->ctx,
+                                            sizeof(arenaChunk)+chunkSize);
+    if (c == NULL) return 0;
+    c->size = chunkSize;
+    c->next = arena->chunks;
+    arena->chunks = c;
+    arena->cur = c->data;
+    arena->end = c->data+chunkSize;
+    return 1;
+}
+
+static void *arenaMalloc(void *ctx, size_t size) {
+    sdsArena *arena = ctx;
+    if (size > ARENA_MAX_ALLOC) return NULL;
+    size_t needed = sizeof(arenaHeader)+ARENA_ROUND(size);
+    if ((size_t)(arena->end-arena->cur) < needed &&
+        !arenaAddChunk(arena,needed)) return NULL;
+
+    arenaHeader *h = (arenaHeader*)arena->cur;
+    h->size = size;
+    arena->cur += needed;
+    arena->last = (char*)(h+1);
+    return arena->last;
+}
+
+static void arenaFree(void *ctx, void *ptr) {
+    sdsArena *arena = ctx;
+    /* Only the most recent allocation can be given back. */
+    if (ptr != NULL && ptr == arena->last) {
+        arena->cur = (char*)ptr-sizeof(arenaHeader);
+        arena->last = NULL;
+    }
+}
+
+static void *arenaRealloc(void *ctx, void *ptr, size_t size) {
+    sdsArena *arena = ctx;
+    if (ptr == NULL) return arenaMalloc(ctx,size);
+    if (size > ARENA_MAX_ALLOC) return NULL;
+
+    arenaHeader *h = (arenaHeader*)ptr-1;
+    if (ptr == arena->last &&
+        (size_t)(arena->end-(char*)ptr) >= ARENA_ROUND(size)) {
+        /* Grow or shrink the most recent allocation in place. */
+        h->size = size;
+        arena->cur = (char*)ptr+ARENA_ROUND(size);
+        return ptr;
+    }
+    if (size <= h->size) {
+        h->size = size;
+        return ptr;
+    }
+
+    void *newptr = arenaMalloc(ctx,size);
+    if (newptr == NULL) return NULL;
+    memcpy(newptr,ptr,h->size);
+    return newptr;
+}
+
+sdsArena *sdsArenaNew(size_t chunkSize, const sdsAllocator *parent) {
+    if (parent == NULL) parent = sdsGetAllocator();
+    sdsArena *arena = parent->mallocFn(parent->ctx,sizeof(sdsArena));
+    if (arena == NULL) return NULL;
+    arena->allocator.mallocFn = arenaMalloc;
+    arena->allocator.reallocFn = arenaRealloc;
+    arena->allocator.freeFn = arenaFree;
+    arena->allocator.ctx = arena;
+    arena->parent = parent;
+    arena->chunkSize = ARENA_ROUND(chunkSize);
+    arena->chunks = NULL;
+    arena->cur = arena->end = arena->last = NULL;
+    return arena;
+}
+
+const sdsAllocator *sdsArenaAllocator(sdsArena *arena) {
+    return &arena->allocator;
+}
+
+void sdsArenaReset(sdsArena *arena) {
+    arenaChunk *keep = NULL, *c = arena->chunks;
+    while (c) {
+        arenaChunk *next = c->next;
+        /* Keep a chunk of the regular size, larger ones were one-offs. */
+        if (keep == NULL && c->size == arena->chunkSize) {
+            keep = c;
+            keep->next = NULL;
+        } else {
+            arena->parent->freeFn(arena->parent->ctx,c);
+        }
+        c = next;
+    }
+    arena->chunks = keep;
+    arena->cur = keep ? keep->data : NULL;
+    arena->end = keep ? keep->data+keep->size : NULL;
+    arena->last = NULL;
+}
+
+void sdsArenaFree(sdsArena *arena) {
+    if (arena == NULL) return;
+    sdsArenaReset(arena);
+    if (arena->chunks)
+        arena->parent->freeFn(arena->parent->ctx,arena->chunks);
+    arena->parent->freeFn(arena->parent->ctx,arena);
+}
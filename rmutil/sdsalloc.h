@@ -31,12 +31,98 @@
 
 /* SDS allocator selection.
  *
- * This file is used in order to change the SDS allocator at compile time.
- * Just define the following defines to what you want to use. Also add
- * the include of your alternate allocator if needed (not needed in order
- * to use the default libc allocator). */
-
-//#include "zmalloc.h"
-#define s_malloc malloc
-#define s_realloc realloc
-#define s_free free
+ * SDS allocates through an allocator selected at runtime, so the same
+ * library can allocate with libc, with RedisModule_Alloc() so that Redis
+ * accounts for the memory of the module (see RMUtil_SDSAllocator in
+ * alloc.h), or from an arena that is released in one shot.
+ *
+ * The allocator of a thread is the one set with sdsUseAllocator() in this
+ * thread if any, and otherwise the process wide one set with
+ * sdsSetAllocator(), which is libc by default. A string must be grown and
+ * freed with the allocator that created it, so only switch allocators
+ * around code that does not touch strings from other allocators. */
+
+#ifndef __SDS_ALLOC_H
+#define __SDS_ALLOC_H
+
+#include <stddef.h>
+
+/* An allocator: functions that behave like malloc(), realloc() and
+ * free(), receiving 'ctx' as their first argument. */
+typedef struct sdsAllocator {
+    void *(*mallocFn)(void *ctx, size_t size);
+    void *(*reallocFn)(void *ctx, void *ptr, size_t size);
+    void (*freeFn)(void *ctx, void *ptr);
+    void *ctx;
+} sdsAllocator;
+
+/* malloc(), realloc() and free() */
+extern const sdsAllocator sdsLibcAllocator;
+
+extern const sdsAllocator *__sdsProcessAllocator;
+extern __thread const sdsAllocator *__sdsThreadAllocator;
+
+/* Set the allocator of all the threads that did not select their own.
+ * NULL restores the libc allocator. Set it before any thread uses SDS,
+ * typically when loading the module. */
+void sdsSetAllocator(const sdsAllocator *a);
+
+/* Set the allocator of the calling thread, or go back to the process
+ * wide allocator with NULL. Returns the previous allocator of the thread,
+ * or NULL if it had none, so that calls can be nested:
+ *
+ * const sdsAllocator *prev = sdsUseAllocator(sdsArenaAllocator(arena));
+ * ... build temporary strings ...
+ * sdsUseAllocator(prev);
+ * sdsArenaFree(arena); */
+const sdsAllocator *sdsUseAllocator(const sdsAllocator *a);
+
+/* Return the allocator of the calling thread. */
+static inline const sdsAllocator *sdsGetAllocator(void) {
+    const sdsAllocator *a = __sdsThreadAllocator;
+    return a ? a : __sdsProcessAllocator;
+}
+
+/* Arena allocator
+ *
+ * Allocations are carved out of large chunks by bumping a pointer, and
+ * are all released at once by sdsArenaReset() or sdsArenaFree(). Freeing
+ * or shrinking the most recent allocation gives its memory back, and so
+ * does growing it in place while the chunk has room, which is what
+ * appending to the last created string does. Other frees do nothing, and
+ * other reallocations copy. Allocations are aligned to 8 bytes.
+ *
+ * An arena is not thread safe. */
+typedef struct sdsArena sdsArena;
+
+/* Create an arena allocating chunks of chunkSize bytes, or more for
+ * larger allocations, from 'parent', or from the current allocator of
+ * the thread if NULL. Returns NULL if out of memory. */
+sdsArena *sdsArenaNew(size_t chunkSize, const sdsAllocator *parent);
+
+/* Return the allocator that allocates from the arena. */
+const sdsAllocator *sdsArenaAllocator(sdsArena *arena);
+
+/* Release all the allocations of the arena, keeping one chunk to reuse. */
+void sdsArenaReset(sdsArena *arena);
+
+/* Release all the allocations of the arena and the arena itself. */
+void sdsArenaFree(sdsArena *arena);
+
+/* The functions SDS allocates with. */
+static inline void *s_malloc(size_t size) {
+    const sdsAllocator *a = sdsGetAllocator();
+    return a->mallocFn(a->ctx,size);
+}
+
+static inline void *s_realloc(void *ptr, size_t size) {
+    const sdsAllocator *a = sdsGetAllocator();
+    return a->reallocFn(a->ctx,ptr,size);
+}
+
+static inline void s_free(void *ptr) {
+    const sdsAllocator *a = sdsGetAllocator();
+    a->freeFn(a->ctx,ptr);
+}
+
+#endif
@@ -0,0 +1,98 @@
+#include "search.h"
+
+// a cache line, used to decide how many levels ahead to prefetch
+#define SEARCH_CACHE_LINE 64
+
+size_t Vector_LowerBound(Vector *v, size_t first, size_t last, void *key, int (*cmp)(void *, void *)) {
+    size_t n = last - first;
+    size_t base = first;
+
+    if (n == 0)
+        return first;
+
+    // the answer is always in [base, base + n]
+    while (n > 1) {
+        size_t half = n / 2;
+        __builtin_prefetch(__vector_GetPtr(v, base + half / 2));
+        __builtin_prefetch(__vector_GetPtr(v, base + half + half / 2));
+        base = cmp(__vector_GetPtr(v, base + half), key) < 0 ? base + half : base;
+        n -= half;
+    }
+    return base + (cmp(__vector_GetPtr(v, base), key) < 0);
+}
+
+size_t Vector_UpperBound(Vector *v, size_t first, size_t last, void *key, int (*cmp)(void *, void *)) {
+    size_t n = last - first;
+    size_t base = first;
+
+    if (n == 0)
+        return first;
+
+    while (n > 1) {
+        size_t half = n / 2;
+        __builtin_prefetch(__vector_GetPtr(v, base + half / 2));
+        __builtin_prefetch(__vector_GetPtr(v, base + half + half / 2));
+        base = cmp(__vector_GetPtr(v, base + half), key) <= 0 ? base + half : base;
+        n -= half;
+    }
+    return base + (cmp(__vector_GetPtr(v, base), key) <= 0);
+}
+
+static inline char *__eytzinger_GetPtr(EytzingerIndex *ei, size_t k) {
+    return ei->data + k * ei->elemSize;
+}
+
+/* Fill the subtree rooted at k with the sorted elements starting at i, in order. Returns the next element to use */
+static size_t __eytzinger_Build(EytzingerIndex *ei, Vector *v, size_t i, size_t k) {
+    if (k <= ei->n) {
+        i = __eytzinger_Build(ei, v, i, 2 * k);
+        memcpy(__eytzinger_GetPtr(ei, k), __vector_GetPtr(v, i++), ei->elemSize);
+        i = __eytzinger_Build(ei, v, i, 2 * k + 1);
+    }
+    return i;
+}
+
+EytzingerIndex *NewEytzingerIndex(Vector *v, int (*cmp)(void *, void *)) {
+    EytzingerIndex *ei = malloc(sizeof(EytzingerIndex));
+    ei->n = v->top;
+    ei->elemSize = v->elemSize;
+    ei->cmp = cmp;
+
+    // the descendants of k, s levels down, are the 2^s contiguous elements at k << s. Prefetch far enough ahead for
+    // them to span a cache line
+    ei->prefetchShift = 1;
+    while (((size_t)1 << ei->prefetchShift) * ei->elemSize < SEARCH_CACHE_LINE) {
+        ei->prefetchShift++;
+    }
+
+    // position 0 is unused so the tree is 1-based
+    ei->data = malloc((ei->n + 1) * ei->elemSize);
+    __eytzinger_Build(ei, v, 0, 1);
+    return ei;
+}
+
+size_t Eytzinger_Index_Size(EytzingerIndex *ei) {
+    return ei->n;
+}
+
+void *Eytzinger_Index_LowerBound(EytzingerIndex *ei, void *key) {
+    size_t k = 1;
+    while (k <= ei->n) {
+        __builtin_prefetch(__eytzinger_GetPtr(ei, k << ei->prefetchShift));
+        k = 2 * k + (ei->cmp(__eytzinger_GetPtr(ei, k), key) < 0);
+    }
+    // we went right after the last time we went left at the answer, so drop the trailing right turns and that left
+    // turn. If we never went left, k becomes 0
+    k >>= __builtin_ffsll(~k);
+    return k ? __eytzinger_GetPtr(ei, k) : NULL;
+}
+
+int Eytzinger_Index_Contains(EytzingerIndex *ei, void *key) {
+    void *p = Eytzinger_Index_LowerBound(ei, key);
+    return p != NULL && ei->cmp(p, key) == 0;
+}
+
+void Eytzinger_Index_Free(EytzingerIndex *ei) {
+    free(ei->data);
+    free(ei);
+}
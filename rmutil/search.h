@@ -0,0 +1,51 @@
+#ifndef __SEARCH_H__
+#define __SEARCH_H__
+
+#include "vector.h"
+
+/* Search a sorted range
+ * Returns the position of the first element in the range [first,last) which does not compare less than key, or last
+ * if all the elements are less than key. The range must be sorted in ascending order according to cmp, which is
+ * called with an element as its first argument and key as its second.
+ * The search is branchless: each step picks the next half with a conditional move rather than a branch, which avoids
+ * mispredictions on large ranges.
+ */
+size_t Vector_LowerBound(Vector *v, size_t first, size_t last, void *key, int (*cmp)(void *, void *));
+
+/* Returns the position of the first element in the range [first,last) which compares greater than key, or last if
+ * there is no such element. Like Vector_LowerBound, the search is branchless.
+ */
+size_t Vector_UpperBound(Vector *v, size_t first, size_t last, void *key, int (*cmp)(void *, void *));
+
+/* Frozen sorted index for lookup heavy workloads
+ * Holds a copy of a sorted vector in Eytzinger (breadth first binary tree) order: the root at position 1, and the
+ * children of position k at 2k and 2k+1. The elements visited by a search are packed at the start of the array, and
+ * the descendants of a node a few levels down are contiguous, so they can be prefetched a few steps ahead.
+ * The index does not change if the source vector changes.
+ */
+typedef struct {
+    char *data;
+    size_t n;
+    size_t elemSize;
+    int prefetchShift;
+
+    int (*cmp)(void *, void *);
+} EytzingerIndex;
+
+/* Build an index from the sorted vector v. cmp is used like in Vector_LowerBound */
+EytzingerIndex *NewEytzingerIndex(Vector *v, int (*cmp)(void *, void *));
+
+/* Return the number of elements in the index */
+size_t Eytzinger_Index_Size(EytzingerIndex *ei);
+
+/* Return a pointer to the first element which does not compare less than key, or NULL if all the elements are less
+ * than key */
+void *Eytzinger_Index_LowerBound(EytzingerIndex *ei, void *key);
+
+/* Return 1 if an element equal to key is in the index, 0 otherwise */
+int Eytzinger_Index_Contains(EytzingerIndex *ei, void *key);
+
+/* free the index and its copy of the elements */
+void Eytzinger_Index_Free(EytzingerIndex *ei);
+
+#endif //__SEARCH_H__
@@ -0,0 +1,361 @@
+#include "setops.h"
+#include "simd.h"
+
+#ifdef RMUTIL_X86_SIMD
+#include <immintrin.h>
+#endif
+
+// SIMD kernels store whole registers, which may write a few elements past the end of the result
+#define SETOPS_SLACK 8
+
+/* Scalar kernels for a given element type T, with function names suffixed by S */
+#define SETOPS_SCALAR_KERNELS(T, S)                                                                                  \
+    /* Return the position of the first element of arr[lo,n) that is not less than key, searching exponentially      \
+     * from lo and then binary searching the last step */                                                            \
+    static inline size_t __gallop_##S(const T *arr, size_t lo, size_t n, T key) {                                    \
+        size_t step = 1, hi = lo;                                                                                    \
+        while (hi < n && arr[hi] < key) {                                                                            \
+            lo = hi + 1;                                                                                             \
+            hi += step;                                                                                              \
+            step <<= 1;                                                                                              \
+        }                                                                                                            \
+        if (hi > n)                                                                                                  \
+            hi = n;                                                                                                  \
+        while (lo < hi) {                                                                                            \
+            size_t mid = lo + (hi - lo) / 2;                                                                         \
+            if (arr[mid] < key)                                                                                      \
+                lo = mid + 1;                                                                                        \
+            else                                                                                                     \
+                hi = mid;                                                                                            \
+        }                                                                                                            \
+        return lo;                                                                                                   \
+    }                                                                                                                \
+                                                                                                                     \
+    static size_t __intersect_scalar_##S(const T *a, size_t na, const T *b, size_t nb, T *out) {                     \
+        size_t i = 0, j = 0, k = 0;                                                                                  \
+        while (i < na && j < nb) {                                                                                   \
+            T x = a[i], y = b[j];                                                                                    \
+            out[k] = x;                                                                                              \
+            k += x == y;                                                                                             \
+            i += x <= y;                                                                                             \
+            j += y <= x;                                                                                             \
+        }                                                                                                            \
+        return k;                                                                                                    \
+    }                                                                                                                \
+                                                                                                                     \
+    /* s is the short input and l the long one */                                                                    \
+    static size_t __intersect_gallop_##S(const T *s, size_t ns, const T *l, size_t nl, T *out) {                     \
+        size_t j = 0, k = 0;                                                                                         \
+        for (size_t i = 0; i < ns; i++) {                                                                            \
+            j = __gallop_##S(l, j, nl, s[i]);                                                                        \
+            if (j == nl)                                                                                             \
+                break;                                                                                               \
+            if (l[j] == s[i])                                                                                        \
+                out[k++] = l[j++];                                                                                   \
+        }                                                                                                            \
+        return k;                                                                                                    \
+    }                                                                                                                \
+                                                                                                                     \
+    static size_t __union_scalar_##S(const T *a, size_t na, const T *b, size_t nb, T *out) {                         \
+        size_t i = 0, j = 0, k = 0;                                                                                  \
+        while (i < na && j < nb) {                                                                                   \
+            T x = a[i], y = b[j];                                                                                    \
+            out[k++] = x < y ? x : y;                                                                                \
+            i += x <= y;                                                                                             \
+            j += y <= x;                                                                                             \
+        }                                                                                                            \
+        memcpy(out + k, a + i, (na - i) * sizeof(T));                                                                \
+        k += na - i;                                                                                                 \
+        memcpy(out + k, b + j, (nb - j) * sizeof(T));                                                                \
+        return k + nb - j;                                                                                           \
+    }                                                                                                                \
+                                                                                                                     \
+    /* s is the short input and l the long one. Runs of l between elements of s are copied in bulk */                \
+    static size_t __union_gallop_##S(const T *s, size_t ns, const T *l, size_t nl, T *out) {                         \
+        size_t i = 0, k = 0;                                                                                         \
+        for (size_t j = 0; j < ns; j++) {                                                                            \
+            size_t p = __gallop_##S(l, i, nl, s[j]);                                                                 \
+            memcpy(out + k, l + i, (p - i) * sizeof(T));                                                             \
+            k += p - i;                                                                                              \
+            i = p;                                                                                                   \
+            out[k++] = s[j];                                                                                         \
+            if (i < nl && l[i] == s[j])                                                                              \
+                i++;                                                                                                 \
+        }                                                                                                            \
+        memcpy(out + k, l + i, (nl - i) * sizeof(T));                                                                \
+        return k + nl - i;                                                                                           \
+    }                                                                                                                \
+                                                                                                                     \
+    static size_t __difference_scalar_##S(const T *a, size_t na, const T *b, size_t nb, T *out) {                    \
+        size_t i = 0, j = 0, k = 0;                                                                                  \
+        while (i < na && j < nb) {                                                                                   \
+            T x = a[i], y = b[j];                                                                                    \
+            out[k] = x;                                                                                              \
+            k += x < y;                                                                                              \
+            i += x <= y;                                                                                             \
+            j += y <= x;                                                                                             \
+        }                                                                                                            \
+        memcpy(out + k, a + i, (na - i) * sizeof(T));                                                                \
+        return k + na - i;                                                                                           \
+    }                                                                                                                \
+                                                                                                                     \
+    /* a is much shorter than b: look each element of a up in b */                                                   \
+    static size_t __difference_gallopA_##S(const T *a, size_t na, const T *b, size_t nb, T *out) {                   \
+        size_t j = 0, k = 0;                                                                                         \
+        for (size_t i = 0; i < na; i++) {                                                                            \
+            j = __gallop_##S(b, j, nb, a[i]);                                                                        \
+            if (j == nb || b[j] != a[i])                                                                             \
+                out[k++] = a[i];                                                                                     \
+        }                                                                                                            \
+        return k;                                                                                                    \
+    }                                                                                                                \
+                                                                                                                     \
+    /* b is much shorter than a: copy the runs of a between elements of b in bulk */                                 \
+    static size_t __difference_gallopB_##S(const T *a, size_t na, const T *b, size_t nb, T *out) {                   \
+        size_t i = 0, k = 0;                                                                                         \
+        for (size_t j = 0; j < nb && i < na; j++) {                                                                  \
+            size_t p = __gallop_##S(a, i, na, b[j]);                                                                 \
+            memcpy(out + k, a + i, (p - i) * sizeof(T));                                                             \
+            k += p - i;                                                                                              \
+            i = p;                                                                                                   \
+            if (i < na && a[i] == b[j])                                                                              \
+                i++;                                                                                                 \
+        }                                                                                                            \
+        memcpy(out + k, a + i, (na - i) * sizeof(T));                                                                \
+        return k + na - i;                                                                                           \
+    }                                                                                                                \
+                                                                                                                     \
+    /* Finish a block kernel with a scalar merge from a[i] and b[j]. The bits of mask flag the elements of the       \
+     * current block of a, starting at i, that were already found in b. Elements found in b are written to out for   \
+     * an intersection, and the others for a difference */                                                           \
+    static size_t __blockTail_##S(const T *a, size_t na, size_t i, const T *b, size_t nb, size_t j, unsigned mask,   \
+                                  int diff, T *out, size_t k) {                                                      \
+        for (; i < na; i++, mask >>= 1) {                                                                            \
+            int found = mask & 1;                                                                                    \
+            if (!found) {                                                                                            \
+                while (j < nb && b[j] < a[i])                                                                        \
+                    j++;                                                                                             \
+                found = j < nb && b[j] == a[i];                                                                      \
+            }                                                                                                        \
+            if (found != diff)                                                                                       \
+                out[k++] = a[i];                                                                                     \
+        }                                                                                                            \
+        return k;                                                                                                    \
+    }
+
+SETOPS_SCALAR_KERNELS(uint32_t, u32)
+SETOPS_SCALAR_KERNELS(uint64_t, u64)
+
+#ifdef RMUTIL_X86_SIMD
+
+/* The SIMD kernels compare a block of a against a block of b, all pairs at once, by comparing a against every
+ * rotation of b. The match bits of the block of a are accumulated until the block of b goes past it, and then its
+ * matching (intersection) or non matching (difference) elements are written out */
+
+/* _mm_shuffle_epi8 masks that pack the 32 bit lanes selected by a 4 bit mask to the front of a register */
+static const uint8_t __compress32[16][16] = {
+    {0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0, 1, 2, 3, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {4, 5, 6, 7, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0, 1, 2, 3, 4, 5, 6, 7, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {8, 9, 10, 11, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0, 1, 2, 3, 8, 9, 10, 11, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {4, 5, 6, 7, 8, 9, 10, 11, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 0x80, 0x80, 0x80, 0x80},
+    {12, 13, 14, 15, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0, 1, 2, 3, 12, 13, 14, 15, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {4, 5, 6, 7, 12, 13, 14, 15, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0, 1, 2, 3, 4, 5, 6, 7, 12, 13, 14, 15, 0x80, 0x80, 0x80, 0x80},
+    {8, 9, 10, 11, 12, 13, 14, 15, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+    {0, 1, 2, 3, 8, 9, 10, 11, 12, 13, 14, 15, 0x80, 0x80, 0x80, 0x80},
+    {4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 0x80, 0x80, 0x80, 0x80},
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+};
+
+/* _mm256_permutevar8x32_epi32 indices that pack the 64 bit lanes selected by a 4 bit mask to the front */
+static const int32_t __compress64[16][8] = {
+    {0, 0, 0, 0, 0, 0, 0, 0},
+    {0, 1, 0, 0, 0, 0, 0, 0},
+    {2, 3, 0, 0, 0, 0, 0, 0},
+    {0, 1, 2, 3, 0, 0, 0, 0},
+    {4, 5, 0, 0, 0, 0, 0, 0},
+    {0, 1, 4, 5, 0, 0, 0, 0},
+    {2, 3, 4, 5, 0, 0, 0, 0},
+    {0, 1, 2, 3, 4, 5, 0, 0},
+    {6, 7, 0, 0, 0, 0, 0, 0},
+    {0, 1, 6, 7, 0, 0, 0, 0},
+    {2, 3, 6, 7, 0, 0, 0, 0},
+    {0, 1, 2, 3, 6, 7, 0, 0},
+    {4, 5, 6, 7, 0, 0, 0, 0},
+    {0, 1, 4, 5, 6, 7, 0, 0},
+    {2, 3, 4, 5, 6, 7, 0, 0},
+    {0, 1, 2, 3, 4, 5, 6, 7},
+};
+
+RMUTIL_TARGET("sse4.2")
+static size_t __setop_sse_u32(const uint32_t *a, size_t na, const uint32_t *b, size_t nb, uint32_t *out, int diff) {
+    size_t i = 0, j = 0, k = 0;
+    unsigned mask = 0;
+    while (i + 4 <= na && j + 4 <= nb) {
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + j));
+        __m128i m0 = _mm_cmpeq_epi32(va, vb);
+        __m128i m1 = _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)));
+        __m128i m2 = _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2)));
+        __m128i m3 = _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)));
+        mask |= _mm_movemask_ps(_mm_castsi128_ps(_mm_or_si128(_mm_or_si128(m0, m1), _mm_or_si128(m2, m3))));
+
+        uint32_t amax = a[i + 3], bmax = b[j + 3];
+        if (amax <= bmax) {
+            unsigned emit = diff ? ~mask & 0xf : mask;
+            __m128i shuf = _mm_loadu_si128((const __m128i *)__compress32[emit]);
+            _mm_storeu_si128((__m128i *)(out + k), _mm_shuffle_epi8(va, shuf));
+            k += __builtin_popcount(emit);
+            i += 4;
+            mask = 0;
+        }
+        if (bmax <= amax)
+            j += 4;
+    }
+    return __blockTail_u32(a, na, i, b, nb, j, mask, diff, out, k);
+}
+
+RMUTIL_TARGET("avx2")
+static size_t __setop_avx2_u32(const uint32_t *a, size_t na, const uint32_t *b, size_t nb, uint32_t *out, int diff) {
+    const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+    size_t i = 0, j = 0, k = 0;
+    unsigned mask = 0;
+    while (i + 8 <= na && j + 8 <= nb) {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + j));
+        __m256i m = _mm256_cmpeq_epi32(va, vb);
+        for (int r = 1; r < 8; r++) {
+            vb = _mm256_permutevar8x32_epi32(vb, rotate);
+            m = _mm256_or_si256(m, _mm256_cmpeq_epi32(va, vb));
+        }
+        mask |= _mm256_movemask_ps(_mm256_castsi256_ps(m));
+
+        uint32_t amax = a[i + 7], bmax = b[j + 7];
+        if (amax <= bmax) {
+            unsigned emit = diff ? ~mask & 0xff : mask;
+            __m128i lo = _mm256_castsi256_si128(va);
+            __m128i hi = _mm256_extracti128_si256(va, 1);
+            _mm_storeu_si128((__m128i *)(out + k),
+                             _mm_shuffle_epi8(lo, _mm_loadu_si128((const __m128i *)__compress32[emit & 0xf])));
+            k += __builtin_popcount(emit & 0xf);
+            _mm_storeu_si128((__m128i *)(out + k),
+                             _mm_shuffle_epi8(hi, _mm_loadu_si128((const __m128i *)__compress32[emit >> 4])));
+            k += __builtin_popcount(emit >> 4);
+            i += 8;
+            mask = 0;
+        }
+        if (bmax <= amax)
+            j += 8;
+    }
+    return __blockTail_u32(a, na, i, b, nb, j, mask, diff, out, k);
+}
+
+RMUTIL_TARGET("avx2")
+static size_t __setop_avx2_u64(const uint64_t *a, size_t na, const uint64_t *b, size_t nb, uint64_t *out, int diff) {
+    size_t i = 0, j = 0, k = 0;
+    unsigned mask = 0;
+    while (i + 4 <= na && j + 4 <= nb) {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + j));
+        __m256i m0 = _mm256_cmpeq_epi64(va, vb);
+        __m256i m1 = _mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, _MM_SHUFFLE(0, 3, 2, 1)));
+        __m256i m2 = _mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, _MM_SHUFFLE(1, 0, 3, 2)));
+        __m256i m3 = _mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, _MM_SHUFFLE(2, 1, 0, 3)));
+        mask |= _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_or_si256(_mm256_or_si256(m0, m1),
+                                                                         _mm256_or_si256(m2, m3))));
+
+        uint64_t amax = a[i + 3], bmax = b[j + 3];
+        if (amax <= bmax) {
+            unsigned emit = diff ? ~mask & 0xf : mask;
+            __m256i perm = _mm256_loadu_si256((const __m256i *)__compress64[emit]);
+            _mm256_storeu_si256((__m256i *)(out + k), _mm256_permutevar8x32_epi32(va, perm));
+            k += __builtin_popcount(emit);
+            i += 4;
+            mask = 0;
+        }
+        if (bmax <= amax)
+            j += 4;
+    }
+    return __blockTail_u64(a, na, i, b, nb, j, mask, diff, out, k);
+}
+
+#endif // RMUTIL_X86_SIMD
+
+/* Clear out and make room for n results, plus slack for the SIMD kernels */
+static void *__setops_Prepare(Vector *out, size_t n) {
+    out->top = 0;
+    Vector_Reserve(out, n + SETOPS_SLACK);
+    return out->data;
+}
+
+/* Intersection or difference of a and b with the best available block kernel. For 64 bit ids, SSE registers only
+ * hold two of them, which is no faster than the scalar merge, so only AVX2 is used */
+static size_t __setop_block_u32(const uint32_t *a, size_t na, const uint32_t *b, size_t nb, uint32_t *out, int diff) {
+#ifdef RMUTIL_X86_SIMD
+    int features = RMUtil_CPUFeatures();
+    if (features & RMUTIL_CPU_AVX2)
+        return __setop_avx2_u32(a, na, b, nb, out, diff);
+    if (features & RMUTIL_CPU_SSE42)
+        return __setop_sse_u32(a, na, b, nb, out, diff);
+#endif
+    return diff ? __difference_scalar_u32(a, na, b, nb, out) : __intersect_scalar_u32(a, na, b, nb, out);
+}
+
+static size_t __setop_block_u64(const uint64_t *a, size_t na, const uint64_t *b, size_t nb, uint64_t *out, int diff) {
+#ifdef RMUTIL_X86_SIMD
+    if (RMUtil_CPUFeatures() & RMUTIL_CPU_AVX2)
+        return __setop_avx2_u64(a, na, b, nb, out, diff);
+#endif
+    return diff ? __difference_scalar_u64(a, na, b, nb, out) : __intersect_scalar_u64(a, na, b, nb, out);
+}
+
+#define SETOPS_FUNCTIONS(T, S, SUFFIX)                                                                               \
+    size_t Vector_Intersect##SUFFIX(Vector *a, Vector *b, Vector *out) {                                             \
+        size_t na = a->top, nb = b->top;                                                                             \
+        const T *pa = (const T *)a->data, *pb = (const T *)b->data;                                                  \
+        T *po = __setops_Prepare(out, na < nb ? na : nb);                                                            \
+                                                                                                                     \
+        if (na * SETOPS_GALLOP_RATIO < nb)                                                                           \
+            out->top = __intersect_gallop_##S(pa, na, pb, nb, po);                                                   \
+        else if (nb * SETOPS_GALLOP_RATIO < na)                                                                      \
+            out->top = __intersect_gallop_##S(pb, nb, pa, na, po);                                                   \
+        else                                                                                                         \
+            out->top = __setop_block_##S(pa, na, pb, nb, po, 0);                                                     \
+        return out->top;                                                                                             \
+    }                                                                                                                \
+                                                                                                                     \
+    size_t Vector_Union##SUFFIX(Vector *a, Vector *b, Vector *out) {                                                 \
+        size_t na = a->top, nb = b->top;                                                                             \
+        const T *pa = (const T *)a->data, *pb = (const T *)b->data;                                                  \
+        T *po = __setops_Prepare(out, na + nb);                                                                      \
+                                                                                                                     \
+        if (na * SETOPS_GALLOP_RATIO < nb)                                                                           \
+            out->top = __union_gallop_##S(pa, na, pb, nb, po);                                                       \
+        else if (nb * SETOPS_GALLOP_RATIO < na)                                                                      \
+            out->top = __union_gallop_##S(pb, nb, pa, na, po);                                                       \
+        else                                                                                                         \
+            out->top = __union_scalar_##S(pa, na, pb, nb, po);                                                       \
+        return out->top;                                                                                             \
+    }                                                                                                                \
+                                                                                                                     \
+    size_t Vector_Difference##SUFFIX(Vector *a, Vector *b, Vector *out) {                                            \
+        size_t na = a->top, nb = b->top;                                                                             \
+        const T *pa = (const T *)a->data, *pb = (const T *)b->data;                                                  \
+        T *po = __setops_Prepare(out, na);                                                                           \
+                                                                                                                     \
+        if (na * SETOPS_GALLOP_RATIO < nb)                                                                           \
+            out->top = __difference_gallopA_##S(pa, na, pb, nb, po);                                                 \
+        else if (nb * SETOPS_GALLOP_RATIO < na)                                                                      \
+            out->top = __difference_gallopB_##S(pa, na, pb, nb, po);                                                 \
+        else                                                                                                         \
+            out->top = __setop_block_##S(pa, na, pb, nb, po, 1);                                                     \
+        return out->top;                                                                                             \
+    }
+
+SETOPS_FUNCTIONS(uint32_t, u32, U32)
+SETOPS_FUNCTIONS(uint64_t, u64, U64)
@@ -0,0 +1,33 @@
+#ifndef __SETOPS_H__
+#define __SETOPS_H__
+
+#include <stdint.h>
+#include "vector.h"
+
+/* Set operations on sorted integer vectors
+ * The inputs are vectors of uint32_t or uint64_t ids, sorted in ascending order and without duplicates. The result
+ * replaces the contents of out, which must have the same element type and must not be one of the inputs. The
+ * functions return the size of the result.
+ *
+ * Intersection and difference use AVX2 block comparison kernels when the CPU supports them (see simd.h), and SSE4.2
+ * kernels for 32 bit ids, with scalar fallbacks. Union is a branchless scalar merge. When one input is much shorter
+ * than the other, all operations switch to galloping search in the longer one, so they cost O(m log(n/m)) rather
+ * than O(n + m).
+ */
+
+/* When one input is at least this many times larger than the other, gallop through it instead of merging */
+#define SETOPS_GALLOP_RATIO 32
+
+/* out = a & b */
+size_t Vector_IntersectU32(Vector *a, Vector *b, Vector *out);
+size_t Vector_IntersectU64(Vector *a, Vector *b, Vector *out);
+
+/* out = a | b */
+size_t Vector_UnionU32(Vector *a, Vector *b, Vector *out);
+size_t Vector_UnionU64(Vector *a, Vector *b, Vector *out);
+
+/* out = a - b */
+size_t Vector_DifferenceU32(Vector *a, Vector *b, Vector *out);
+size_t Vector_DifferenceU64(Vector *a, Vector *b, Vector *out);
+
+#endif //__SETOPS_H__
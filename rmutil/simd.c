@@ -0,0 +1,25 @@
+#include "simd.h"
+
+// -1 until detected. Detection is idempotent, so a race on first use is benign
+static int __cpuFeatures = -1;
+static int __cpuFeaturesMask = -1;
+
+static int __detectCPUFeatures(void) {
+  int features = 0;
+#ifdef RMUTIL_X86_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse2")) features |= RMUTIL_CPU_SSE2;
+  if (__builtin_cpu_supports("sse4.2")) features |= RMUTIL_CPU_SSE42;
+  if (__builtin_cpu_supports("avx2")) features |= RMUTIL_CPU_AVX2;
+#endif
+  return features;
+}
+
+int RMUtil_CPUFeatures(void) {
+  if (__cpuFeatures == -1) {
+    __cpuFeatures = __detectCPUFeatures();
+  }
+  return __cpuFeatures & __cpuFeaturesMask;
+}
+
+void RMUtil_SetCPUFeatures(int features) { __cpuFeaturesMask = features; }
@@ -0,0 +1,30 @@
+#ifndef __RMUTIL_SIMD_H__
+#define __RMUTIL_SIMD_H__
+
+/* Runtime CPU feature detection for SIMD kernels.
+ *
+ * SIMD kernels in rmutil are compiled with per-function target attributes, so
+ * the library itself builds with the default compiler flags. Callers check
+ * RMUtil_CPUFeatures() and pick the best kernel at runtime, falling back to a
+ * scalar implementation on other CPUs and architectures.
+ */
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define RMUTIL_X86_SIMD 1
+#define RMUTIL_TARGET(t) __attribute__((target(t)))
+#endif
+
+/* CPU feature flags */
+#define RMUTIL_CPU_SSE2 0x01
+#define RMUTIL_CPU_SSE42 0x02
+#define RMUTIL_CPU_AVX2 0x04
+
+/* Return the RMUTIL_CPU_* features supported by this CPU and enabled */
+int RMUtil_CPUFeatures(void);
+
+/* Restrict the features used by SIMD kernels to the given RMUTIL_CPU_* mask.
+ * Features the CPU does not support stay disabled. This is mostly useful for
+ * testing and benchmarking the fallback paths */
+void RMUtil_SetCPUFeatures(int features);
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef __SMALL_VECTOR_H__
+#define __SMALL_VECTOR_H__
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/*
+* Small-buffer-optimized typed vector.
+* RMUTIL_SMALL_VECTOR_DECLARE(type, n, name) declares a vector called `name`
+* that keeps its first n elements inline in the struct itself, and only moves
+* them to a heap allocated buffer once it outgrows them.
+*
+* The struct can be embedded in another struct and initialized with
+* name_Init, in which case a vector that never spills makes no allocations at
+* all, or allocated with Newname, which makes a single allocation.
+* Sizes are 32 bit to keep the header small.
+*
+* e.g.
+*   RMUTIL_SMALL_VECTOR_DECLARE(uint64_t, 8, IdList)
+*
+*   struct myValue { IdList ids; };
+*   IdList_Init(&val->ids);
+*   IdList_Push(&val->ids, 1337);
+*   ...
+*   IdList_Clear(&val->ids);
+*/
+#define RMUTIL_SMALL_VECTOR_DECLARE(type, n, name)                             \
+  typedef struct {                                                             \
+    uint32_t top;                                                              \
+    uint32_t cap;                                                              \
+    union {                                                                    \
+      type *heap;                                                              \
+      type inl[n];                                                             \
+    } u;                                                                       \
+  } name;                                                                      \
+                                                                               \
+  /* initialize an embedded vector, without allocating anything */             \
+  static inline void name##_Init(name *v) {                                    \
+    v->top = 0;                                                                \
+    v->cap = n;                                                                \
+  }                                                                            \
+                                                                               \
+  static inline name *New##name(void) {                                        \
+    name *v = malloc(sizeof(name));                                            \
+    name##_Init(v);                                                            \
+    return v;                                                                  \
+  }                                                                            \
+                                                                               \
+  /* return 1 if the elements are still stored inline */                       \
+  static inline int name##_IsInline(name *v) { return v->cap <= (n); }         \
+                                                                               \
+  /* return a pointer to the contiguous array of elements */                   \
+  static inline type *name##_Data(name *v) {                                   \
+    return name##_IsInline(v) ? v->u.inl : v->u.heap;                          \
+  }                                                                            \
+                                                                               \
+  /* make sure v can hold newcap elements, spilling to the heap if needed */   \
+  static inline void name##_Reserve(name *v, uint32_t newcap) {                \
+    if (newcap <= v->cap) {                                                    \
+      return;                                                                  \
+    }                                                                          \
+    if (name##_IsInline(v)) {                                                  \
+      type *heap = malloc(newcap * sizeof(type));                              \
+      memcpy(heap, v->u.inl, v->top * sizeof(type));                           \
+      v->u.heap = heap;                                                        \
+    } else {                                                                   \
+      v->u.heap = realloc(v->u.heap, newcap * sizeof(type));                   \
+    }                                                                          \
+    v->cap = newcap;                                                           \
+  }                                                                            \
+                                                                               \
+  /* push elem at the end of v, return the new size, or 0 if v is full at      \
+   * UINT32_MAX elements */                                                    \
+  static inline uint32_t name##_Push(name *v, type elem) {                     \
+    if (v->top == v->cap) {                                                    \
+      if (v->cap == UINT32_MAX) {                                              \
+        return 0;                                                              \
+      }                                                                        \
+      /* an empty inline buffer has no capacity to double, and doubling past   \
+       * 2^31 would wrap */                                                    \
+      name##_Reserve(v, v->cap == 0               ? 1                          \
+                        : v->cap > UINT32_MAX / 2 ? UINT32_MAX                 \
+                                                  : v->cap * 2);               \
+    }                                                                          \
+    name##_Data(v)[v->top++] = elem;                                           \
+    return v->top;                                                             \
+  }                                                                            \
+                                                                               \
+  /* copy the element at pos to ptr. return 0 if pos is out of bounds */       \
+  static inline int name##_Get(name *v, uint32_t pos, type *ptr) {             \
+    if (pos >= v->top) {                                                       \
+      return 0;                                                                \
+    }                                                                          \
+    *ptr = name##_Data(v)[pos];                                                \
+    return 1;                                                                  \
+  }                                                                            \
+                                                                               \
+  /* get a pointer to the element at pos, or NULL if it is out of bounds */    \
+  static inline type *name##_GetPtr(name *v, uint32_t pos) {                   \
+    return pos < v->top ? name##_Data(v) + pos : NULL;                         \
+  }                                                                            \
+                                                                               \
+  /* remove the last element, copying it to ptr if it is not NULL */           \
+  static inline int name##_Pop(name *v, type *ptr) {                           \
+    if (v->top == 0) {                                                         \
+      return 0;                                                                \
+    }                                                                          \
+    v->top--;                                                                  \
+    if (ptr) {                                                                 \
+      *ptr = name##_Data(v)[v->top];                                           \
+    }                                                                          \
+    return 1;                                                                  \
+  }                                                                            \
+                                                                               \
+  static inline uint32_t name##_Size(name *v) { return v->top; }               \
+                                                                               \
+  static inline uint32_t name##_Cap(name *v) { return v->cap; }                \
+                                                                               \
+  /* release the heap buffer of an embedded vector, leaving it empty */        \
+  static inline void name##_Clear(name *v) {                                   \
+    if (!name##_IsInline(v)) {                                                 \
+      free(v->u.heap);                                                         \
+    }                                                                          \
+    name##_Init(v);                                                            \
+  }                                                                            \
+                                                                               \
+  /* free a vector created with Newname */                                     \
+  static inline void name##_Free(name *v) {                                    \
+    name##_Clear(v);                                                           \
+    free(v);                                                                   \
+  }
+
+#endif
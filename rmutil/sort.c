@@ -0,0 +1,300 @@
+#include <stdint.h>
+#include "sort.h"
+#include "heap.h"
+
+// ranges shorter than this are finished with insertion sort
+#define SORT_INSERTION_THRESHOLD 16
+
+static inline void __sort_swap(Vector *v, size_t i, size_t j, char *tmp) {
+    memcpy(tmp, __vector_GetPtr(v, i), v->elemSize);
+    memcpy(__vector_GetPtr(v, i), __vector_GetPtr(v, j), v->elemSize);
+    memcpy(__vector_GetPtr(v, j), tmp, v->elemSize);
+}
+
+static void __insertion_sort(Vector *v, size_t first, size_t last, int (*cmp)(void *, void *), char *tmp) {
+    for (size_t i = first + 1; i < last; i++) {
+        if (cmp(__vector_GetPtr(v, i), __vector_GetPtr(v, i - 1)) >= 0)
+            continue;
+        memcpy(tmp, __vector_GetPtr(v, i), v->elemSize);
+        size_t j = i;
+        do {
+            memcpy(__vector_GetPtr(v, j), __vector_GetPtr(v, j - 1), v->elemSize);
+            --j;
+        } while (j > first && cmp(tmp, __vector_GetPtr(v, j - 1)) < 0);
+        memcpy(__vector_GetPtr(v, j), tmp, v->elemSize);
+    }
+}
+
+static void __sort_heap(Vector *v, size_t first, size_t last, int (*cmp)(void *, void *)) {
+    for (; last - first > 1; --last) {
+        Heap_Pop(v, first, last, cmp);
+    }
+}
+
+/* Partition [first,last) around the median of its first, middle and last elements.
+ * Returns the final position of the pivot: elements before it are not greater, and elements after it are not less */
+static size_t __partition(Vector *v, size_t first, size_t last, int (*cmp)(void *, void *), char *pivot, char *tmp) {
+    size_t mid = first + (last - first) / 2;
+    size_t lo = first, hi = last - 1;
+
+    // order first, mid and last-1, then move the median to first
+    if (cmp(__vector_GetPtr(v, mid), __vector_GetPtr(v, lo)) < 0)
+        __sort_swap(v, mid, lo, tmp);
+    if (cmp(__vector_GetPtr(v, hi), __vector_GetPtr(v, mid)) < 0) {
+        __sort_swap(v, hi, mid, tmp);
+        if (cmp(__vector_GetPtr(v, mid), __vector_GetPtr(v, lo)) < 0)
+            __sort_swap(v, mid, lo, tmp);
+    }
+    __sort_swap(v, first, mid, tmp);
+    memcpy(pivot, __vector_GetPtr(v, first), v->elemSize);
+
+    // both scans stop on elements equal to the pivot, which keeps ranges of equal elements balanced.
+    // last-1 is not less than the pivot, and first is the pivot itself, so neither scan can run out of the range
+    size_t i = first, j = last;
+    for (;;) {
+        do {
+            ++i;
+        } while (cmp(__vector_GetPtr(v, i), pivot) < 0);
+        do {
+            --j;
+        } while (cmp(pivot, __vector_GetPtr(v, j)) < 0);
+        if (i >= j)
+            break;
+        __sort_swap(v, i, j, tmp);
+    }
+    __sort_swap(v, first, j, tmp);
+    return j;
+}
+
+static size_t __depth_limit(size_t len) {
+    size_t depth = 0;
+    while (len > 1) {
+        len >>= 1;
+        depth += 2;
+    }
+    return depth;
+}
+
+void Vector_Sort(Vector *v, size_t first, size_t last, int (*cmp)(void *, void *)) {
+    if (last - first < 2)
+        return;
+
+    char pivot[v->elemSize];
+    char tmp[v->elemSize];
+
+    // explicit stack of pending ranges. We always push the larger side and loop on the smaller one, so this can't
+    // grow beyond the number of bits in size_t
+    size_t stack[2 * 8 * sizeof(size_t)][3];
+    size_t sp = 0;
+    size_t depth = __depth_limit(last - first);
+
+    for (;;) {
+        while (last - first > SORT_INSERTION_THRESHOLD) {
+            if (depth == 0) {
+                // quicksort is degenerating, heap sort what's left
+                Make_Heap(v, first, last, cmp);
+                __sort_heap(v, first, last, cmp);
+                break;
+            }
+            --depth;
+
+            size_t p = __partition(v, first, last, cmp, pivot, tmp);
+            if (p - first < last - (p + 1)) {
+                stack[sp][0] = p + 1;
+                stack[sp][1] = last;
+                stack[sp][2] = depth;
+                last = p;
+            } else {
+                stack[sp][0] = first;
+                stack[sp][1] = p;
+                stack[sp][2] = depth;
+                first = p + 1;
+            }
+            ++sp;
+        }
+        __insertion_sort(v, first, last, cmp, tmp);
+
+        if (sp == 0)
+            break;
+        --sp;
+        first = stack[sp][0];
+        last = stack[sp][1];
+        depth = stack[sp][2];
+    }
+}
+
+void Vector_PartialSort(Vector *v, size_t first, size_t middle, size_t last, int (*cmp)(void *, void *)) {
+    if (middle <= first)
+        return;
+    if (middle > last)
+        middle = last;
+
+    char tmp[v->elemSize];
+
+    // keep the smallest elements seen so far in a max-heap at [first,middle), replacing its top with any smaller one
+    Make_Heap(v, first, middle, cmp);
+    for (size_t i = middle; i < last; i++) {
+        if (cmp(__vector_GetPtr(v, i), __vector_GetPtr(v, first)) < 0) {
+            __sort_swap(v, i, first, tmp);
+            __sift_down(v, first, middle, cmp, first);
+        }
+    }
+    __sort_heap(v, first, middle, cmp);
+}
+
+void Vector_NthElement(Vector *v, size_t first, size_t nth, size_t last, int (*cmp)(void *, void *)) {
+    if (nth >= last || last - first < 2)
+        return;
+
+    char pivot[v->elemSize];
+    char tmp[v->elemSize];
+    size_t depth = __depth_limit(last - first);
+
+    while (last - first > SORT_INSERTION_THRESHOLD) {
+        if (depth == 0) {
+            // quickselect is degenerating, select with the heap instead
+            Vector_PartialSort(v, first, nth + 1, last, cmp);
+            return;
+        }
+        --depth;
+
+        size_t p = __partition(v, first, last, cmp, pivot, tmp);
+        if (p == nth)
+            return;
+        if (nth < p)
+            last = p;
+        else
+            first = p + 1;
+    }
+    __insertion_sort(v, first, last, cmp, tmp);
+}
+
+/* Map a key to an unsigned integer with the same ordering */
+static inline uint64_t __radix_key(const char *p, RadixKeyType type) {
+    uint32_t u32;
+    uint64_t u64;
+    switch (type) {
+        case RADIX_KEY_UINT32:
+            memcpy(&u32, p, sizeof(u32));
+            return u32;
+        case RADIX_KEY_INT32:
+            memcpy(&u32, p, sizeof(u32));
+            return u32 ^ 0x80000000u;
+        case RADIX_KEY_UINT64:
+            memcpy(&u64, p, sizeof(u64));
+            return u64;
+        case RADIX_KEY_INT64:
+            memcpy(&u64, p, sizeof(u64));
+            return u64 ^ 0x8000000000000000ull;
+        case RADIX_KEY_DOUBLE:
+            // flip all bits of negatives, so that larger magnitudes sort first, and only the sign bit of positives
+            memcpy(&u64, p, sizeof(u64));
+            return (u64 & 0x8000000000000000ull) ? ~u64 : u64 ^ 0x8000000000000000ull;
+    }
+    return 0;
+}
+
+/* Inverse of __radix_key, writing the original key back to p */
+static inline void __radix_unkey(char *p, uint64_t k, RadixKeyType type) {
+    uint32_t u32;
+    switch (type) {
+        case RADIX_KEY_UINT32:
+        case RADIX_KEY_INT32:
+            u32 = (uint32_t)k ^ (type == RADIX_KEY_INT32 ? 0x80000000u : 0);
+            memcpy(p, &u32, sizeof(u32));
+            break;
+        case RADIX_KEY_UINT64:
+        case RADIX_KEY_INT64:
+            k ^= (type == RADIX_KEY_INT64 ? 0x8000000000000000ull : 0);
+            memcpy(p, &k, sizeof(k));
+            break;
+        case RADIX_KEY_DOUBLE:
+            k = (k & 0x8000000000000000ull) ? k ^ 0x8000000000000000ull : ~k;
+            memcpy(p, &k, sizeof(k));
+            break;
+    }
+}
+
+typedef struct {
+    uint64_t key;
+    size_t idx;
+} __radixEntry;
+
+/* LSD radix sort of the n entries in src on the low nbytes bytes of their keys, using dst as scratch space of the
+ * same size. src and dst are swapped on every pass, so the sorted result ends up in src */
+#define RADIX_SORT_PASSES(T, src, dst, n, nbytes, KEY)                                \
+    do {                                                                              \
+        size_t __counts[8][256];                                                      \
+        memset(__counts, 0, sizeof(__counts));                                        \
+        for (size_t __i = 0; __i < (n); __i++) {                                      \
+            uint64_t __k = KEY((src)[__i]);                                           \
+            for (int __b = 0; __b < (nbytes); __b++)                                  \
+                __counts[__b][(__k >> (8 * __b)) & 0xff]++;                           \
+        }                                                                             \
+        for (int __b = 0; __b < (nbytes); __b++) {                                    \
+            size_t *__c = __counts[__b];                                              \
+            /* skip digits that are the same in all keys */                           \
+            if (__c[(KEY((src)[0]) >> (8 * __b)) & 0xff] == (n))                      \
+                continue;                                                             \
+            size_t __sum = 0;                                                         \
+            for (int __d = 0; __d < 256; __d++) {                                     \
+                size_t __t = __c[__d];                                                \
+                __c[__d] = __sum;                                                     \
+                __sum += __t;                                                         \
+            }                                                                         \
+            for (size_t __i = 0; __i < (n); __i++) {                                  \
+                (dst)[__c[(KEY((src)[__i]) >> (8 * __b)) & 0xff]++] = (src)[__i];     \
+            }                                                                         \
+            T *__t = (src);                                                           \
+            (src) = (dst);                                                            \
+            (dst) = __t;                                                              \
+        }                                                                             \
+    } while (0)
+
+#define __RADIX_KEY_SELF(k) (k)
+#define __RADIX_KEY_ENTRY(e) ((e).key)
+
+void Vector_RadixSort(Vector *v, size_t first, size_t last, RadixKeyType type, size_t keyOffset) {
+    if (last - first < 2)
+        return;
+
+    size_t n = last - first;
+    int nbytes = (type == RADIX_KEY_UINT32 || type == RADIX_KEY_INT32) ? 4 : 8;
+
+    if (keyOffset == 0 && v->elemSize == (size_t)nbytes) {
+        // the elements are the keys, sort them directly
+        uint64_t *keys = malloc(n * sizeof(uint64_t));
+        uint64_t *scratch = malloc(n * sizeof(uint64_t));
+        for (size_t i = 0; i < n; i++) {
+            keys[i] = __radix_key(__vector_GetPtr(v, first + i), type);
+        }
+        uint64_t *src = keys, *dst = scratch;
+        RADIX_SORT_PASSES(uint64_t, src, dst, n, nbytes, __RADIX_KEY_SELF);
+        for (size_t i = 0; i < n; i++) {
+            __radix_unkey(__vector_GetPtr(v, first + i), src[i], type);
+        }
+        free(keys);
+        free(scratch);
+        return;
+    }
+
+    // sort (key, index) pairs, then permute the elements accordingly
+    __radixEntry *entries = malloc(n * sizeof(__radixEntry));
+    __radixEntry *scratch = malloc(n * sizeof(__radixEntry));
+    for (size_t i = 0; i < n; i++) {
+        entries[i].key = __radix_key(__vector_GetPtr(v, first + i) + keyOffset, type);
+        entries[i].idx = first + i;
+    }
+    __radixEntry *src = entries, *dst = scratch;
+    RADIX_SORT_PASSES(__radixEntry, src, dst, n, nbytes, __RADIX_KEY_ENTRY);
+
+    char *elems = malloc(n * v->elemSize);
+    for (size_t i = 0; i < n; i++) {
+        memcpy(elems + i * v->elemSize, __vector_GetPtr(v, src[i].idx), v->elemSize);
+    }
+    memcpy(__vector_GetPtr(v, first), elems, n * v->elemSize);
+
+    free(elems);
+    free(entries);
+    free(scratch);
+}
@@ -0,0 +1,50 @@
+#ifndef __SORT_H__
+#define __SORT_H__
+
+#include "vector.h"
+
+/* Sort range
+ * Sorts the elements in the range [first,last) into ascending order, so that cmp(a, b) <= 0 for every element a that
+ * precedes an element b.
+ * The sort is an introsort: a median-of-three quicksort that finishes small ranges with insertion sort, and falls
+ * back to heap sort if the recursion gets too deep, so it is O(n log n) in the worst case. It is not stable.
+ */
+void Vector_Sort(Vector *v, size_t first, size_t last, int (*cmp)(void *, void *));
+
+/* Partially sort range
+ * Rearranges the elements in the range [first,last), in such a way that the elements before middle are the smallest
+ * elements in the entire range and are sorted in ascending order, while the remaining elements are left without any
+ * specific order.
+ * Built on the heap functions, it takes O(n log k) where k is middle - first.
+ */
+void Vector_PartialSort(Vector *v, size_t first, size_t middle, size_t last, int (*cmp)(void *, void *));
+
+/* Sort element in range
+ * Rearranges the elements in the range [first,last), in such a way that the element at the nth position is the
+ * element that would be in that position in a sorted sequence. None of the elements preceding nth are greater than
+ * it, and none of the elements following it are less.
+ * Takes O(n) on average, and falls back to a heap based selection in the worst case.
+ */
+void Vector_NthElement(Vector *v, size_t first, size_t nth, size_t last, int (*cmp)(void *, void *));
+
+/* Key types for Vector_RadixSort */
+typedef enum {
+    RADIX_KEY_UINT32,
+    RADIX_KEY_INT32,
+    RADIX_KEY_UINT64,
+    RADIX_KEY_INT64,
+    RADIX_KEY_DOUBLE,
+} RadixKeyType;
+
+/* Radix sort range
+ * Sorts the elements in the range [first,last) into ascending order of a fixed width numeric key, found at keyOffset
+ * bytes into each element. If the elements are the keys themselves, keyOffset is 0.
+ * This is an LSD radix sort on 8 bit digits. It is stable, and skips digits that are equal in all keys. Doubles are
+ * ordered by value, with -0.0 before 0.0 and NaNs sorted to the ends by their sign.
+ * It needs temporary memory proportional to the range size.
+ * e.g. to sort records by a double score field:
+ *   Vector_RadixSort(v, 0, Vector_Size(v), RADIX_KEY_DOUBLE, offsetof(struct record, score));
+ */
+void Vector_RadixSort(Vector *v, size_t first, size_t last, RadixKeyType type, size_t keyOffset);
+
+#endif //__SORT_H__
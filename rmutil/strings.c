@@ -2,6 +2,7 @@
 #include <sys/param.h>
 #include <ctype.h>
 #include "strings.h"
+#include "bytes.h"
 
 
 #include "sds.h"
@@ -46,22 +47,11 @@ void RMUtil_StringToLower(RedisModuleString *s) {
     
     size_t l;
     char *c = (char *)RedisModule_StringPtrLen(s, &l);
-    size_t i;
-    for (i = 0; i < l; i++) {
-        *c = tolower(*c);
-        ++c;
-    }
-    
+    RMUtil_ASCIIToLower(c, l);
 }
 
 void RMUtil_StringToUpper(RedisModuleString *s) {
     size_t l;
     char *c = (char *)RedisModule_StringPtrLen(s, &l);
-    size_t i;
-    for (i = 0; i < l; i++) {
-        *c = toupper(*c);
-        ++c;
-    }
-    
-    
+    RMUtil_ASCIIToUpper(c, l);
 }
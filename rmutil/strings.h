@@ -15,9 +15,9 @@ int RMUtil_StringEquals(RedisModuleString *s1, RedisModuleString *s2);
 /* Return 1 if the string is equal to a C NULL terminated string. Case *sensitive* */
 int RMUtil_StringEqualsC(RedisModuleString *s1, const char *s2);
 
-/* Converts a redis string to lowercase in place without reallocating anything */
+/* Converts the ASCII letters of a redis string to lowercase in place without reallocating anything */
 void RMUtil_StringToLower(RedisModuleString *s);
 
-/* Converts a redis string to uppercase in place without reallocating anything */
+/* Converts the ASCII letters of a redis string to uppercase in place without reallocating anything */
 void RMUtil_StringToUpper(RedisModuleString *s);
 #endif
@@ -0,0 +1,171 @@
+#include <stdio.h>
+#include <math.h>
+#include "aggregate.h"
+#include "simd.h"
+#include "assert.h"
+
+void fill(Vector *vi, Vector *vd, size_t n) {
+    vi->top = vd->top = 0;
+    for (size_t i = 0; i < n; i++) {
+        int64_t x = (int64_t)(rand() % 2000001) - 1000000;
+        double d = x / 7.0;
+        __vector_PushPtr(vi, &x);
+        __vector_PushPtr(vd, &d);
+    }
+}
+
+int64_t geti(Vector *v, size_t i) {
+    return *(int64_t *)Vector_GetPtr(v, i);
+}
+
+double getd(Vector *v, size_t i) {
+    return *(double *)Vector_GetPtr(v, i);
+}
+
+int approx(double a, double b) {
+    return fabs(a - b) <= 1e-9 * (1 + fabs(a) + fabs(b));
+}
+
+void testReductions(Vector *vi, Vector *vd) {
+    size_t n = Vector_Size(vi);
+    size_t ranges[][2] = {{0, n}, {0, 0}, {1, n}, {n / 3, n / 2}, {n, n + 5}, {0, n + 100}};
+    for (int r = 0; r < sizeof(ranges) / sizeof(ranges[0]); r++) {
+        size_t first = ranges[r][0], last = ranges[r][1] > n ? n : ranges[r][1];
+        if (first > last)
+            first = last;
+
+        int64_t si = 0, mini = INT64_MAX, maxi = INT64_MIN;
+        double sd = 0, mind = INFINITY, maxd = -INFINITY;
+        for (size_t i = first; i < last; i++) {
+            si += geti(vi, i);
+            sd += getd(vd, i);
+            mini = geti(vi, i) < mini ? geti(vi, i) : mini;
+            maxi = geti(vi, i) > maxi ? geti(vi, i) : maxi;
+            mind = getd(vd, i) < mind ? getd(vd, i) : mind;
+            maxd = getd(vd, i) > maxd ? getd(vd, i) : maxd;
+        }
+
+        assert(Vector_SumI64(vi, ranges[r][0], ranges[r][1]) == si);
+        assert(approx(Vector_SumDouble(vd, ranges[r][0], ranges[r][1]), sd));
+
+        int64_t xi = 0;
+        double xd = 0;
+        int found = last > first;
+        assert(Vector_MinI64(vi, ranges[r][0], ranges[r][1], &xi) == found);
+        assert(!found || xi == mini);
+        assert(Vector_MaxI64(vi, ranges[r][0], ranges[r][1], &xi) == found);
+        assert(!found || xi == maxi);
+        assert(Vector_MinDouble(vd, ranges[r][0], ranges[r][1], &xd) == found);
+        assert(!found || xd == mind);
+        assert(Vector_MaxDouble(vd, ranges[r][0], ranges[r][1], &xd) == found);
+        assert(!found || xd == maxd);
+    }
+}
+
+void testPrefixSums(Vector *vi, Vector *vd) {
+    Vector *oi = NewVector(int64_t, 0);
+    Vector *od = NewVector(double, 0);
+    Vector_PrefixSumI64(vi, oi);
+    Vector_PrefixSumDouble(vd, od);
+    assert(Vector_Size(oi) == Vector_Size(vi));
+    assert(Vector_Size(od) == Vector_Size(vd));
+
+    int64_t si = 0;
+    double sd = 0;
+    for (size_t i = 0; i < Vector_Size(vi); i++) {
+        si += geti(vi, i);
+        sd += getd(vd, i);
+        assert(geti(oi, i) == si);
+        assert(getd(od, i) == sd);
+    }
+    Vector_Free(oi);
+    Vector_Free(od);
+}
+
+void testSliding(Vector *vi, Vector *vd, size_t w) {
+    size_t n = Vector_Size(vi);
+    size_t expected = w == 0 || w > n ? 0 : n - w + 1;
+    Vector *out = NewVector(int64_t, 0);
+
+    // compare every window against a rescan
+    for (int agg = 0; agg < 8; agg++) {
+        size_t got;
+        switch (agg) {
+        case 0: got = Vector_SlidingMinI64(vi, w, out); break;
+        case 1: got = Vector_SlidingMaxI64(vi, w, out); break;
+        case 2: got = Vector_SlidingSumI64(vi, w, out); break;
+        case 3: got = Vector_SlidingMeanI64(vi, w, out); break;
+        case 4: got = Vector_SlidingMinDouble(vd, w, out); break;
+        case 5: got = Vector_SlidingMaxDouble(vd, w, out); break;
+        case 6: got = Vector_SlidingSumDouble(vd, w, out); break;
+        default: got = Vector_SlidingMeanDouble(vd, w, out); break;
+        }
+        assert(got == expected);
+        assert(Vector_Size(out) == expected);
+
+        for (size_t i = 0; i < got; i++) {
+            int64_t mini = geti(vi, i), maxi = mini, si = 0;
+            double mind = getd(vd, i), maxd = mind, sd = 0;
+            for (size_t j = i; j < i + w; j++) {
+                mini = geti(vi, j) < mini ? geti(vi, j) : mini;
+                maxi = geti(vi, j) > maxi ? geti(vi, j) : maxi;
+                mind = getd(vd, j) < mind ? getd(vd, j) : mind;
+                maxd = getd(vd, j) > maxd ? getd(vd, j) : maxd;
+                si += geti(vi, j);
+                sd += getd(vd, j);
+            }
+            switch (agg) {
+            case 0: assert(geti(out, i) == mini); break;
+            case 1: assert(geti(out, i) == maxi); break;
+            case 2: assert(geti(out, i) == si); break;
+            case 3: assert(approx(getd(out, i), (double)si / w)); break;
+            case 4: assert(getd(out, i) == mind); break;
+            case 5: assert(getd(out, i) == maxd); break;
+            case 6: assert(approx(getd(out, i), sd)); break;
+            default: assert(approx(getd(out, i), sd / w)); break;
+            }
+        }
+    }
+    Vector_Free(out);
+}
+
+int main(int argc, char **argv) {
+    Vector *vi = NewVector(int64_t, 0);
+    Vector *vd = NewVector(double, 0);
+    size_t sizes[] = {0, 1, 3, 8, 17, 100, 1001};
+    int features[] = {RMUtil_CPUFeatures(), 0};
+
+    for (int f = 0; f < 2; f++) {
+        RMUtil_SetCPUFeatures(features[f]);
+        for (int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            fill(vi, vd, sizes[s]);
+            testReductions(vi, vd);
+            testPrefixSums(vi, vd);
+        }
+    }
+    RMUtil_SetCPUFeatures(-1);
+
+    // monotonic runs are the worst case for the deque
+    vi->top = vd->top = 0;
+    for (int64_t i = 0; i < 50; i++) {
+        int64_t x = i < 25 ? i : 50 - i;
+        double d = x;
+        Vector_Push(vi, x);
+        Vector_Push(vd, d);
+    }
+    size_t windows[] = {0, 1, 2, 5, 25, 49, 50, 51};
+    for (int w = 0; w < sizeof(windows) / sizeof(windows[0]); w++) {
+        testSliding(vi, vd, windows[w]);
+    }
+
+    fill(vi, vd, 300);
+    for (int w = 0; w < sizeof(windows) / sizeof(windows[0]); w++) {
+        testSliding(vi, vd, windows[w]);
+    }
+    testSliding(vi, vd, 300);
+
+    Vector_Free(vi);
+    Vector_Free(vd);
+    printf("PASS!");
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "assert.h"
+#include "bytes.h"
+#include "simd.h"
+
+/* Naive separator search */
+const char *find_ref(const char *p, size_t n, const char *sep, size_t seplen) {
+    for (size_t i = 0; i + seplen <= n; i++) {
+        if (!memcmp(p + i, sep, seplen))
+            return p + i;
+    }
+    return NULL;
+}
+
+/* Search every suffix of buf, so that matches fall on every position of the SIMD blocks and their tails */
+void check_find(const char *buf, size_t n, const char *sep, size_t seplen) {
+    for (size_t i = 0; i <= n; i++) {
+        assert(find_ref(buf + i, n - i, sep, seplen) == RMUtil_FindSep(buf + i, n - i, sep, seplen));
+        if (seplen == 1) {
+            assert(find_ref(buf + i, n - i, sep, 1) == RMUtil_FindByte(buf + i, n - i, sep[0]));
+        }
+    }
+}
+
+void check_case(const char *buf, size_t n) {
+    char lower[n + 1], upper[n + 1];
+    memcpy(lower, buf, n);
+    memcpy(upper, buf, n);
+    // a guard byte, which must not be touched
+    lower[n] = upper[n] = 'Q';
+    RMUtil_ASCIIToLower(lower, n);
+    RMUtil_ASCIIToUpper(upper, n);
+    for (size_t i = 0; i < n; i++) {
+        assert(lower[i] == (char)tolower((unsigned char)buf[i]));
+        assert(upper[i] == (char)toupper((unsigned char)buf[i]));
+    }
+    assert(lower[n] == 'Q' && upper[n] == 'Q');
+}
+
+int main(int argc, char **argv) {
+    int features[] = {RMUtil_CPUFeatures(), RMUTIL_CPU_SSE2, 0};
+    char buf[200], sep[8];
+
+    for (int f = 0; f < 3; f++) {
+        RMUtil_SetCPUFeatures(features[f]);
+
+        assert(buf == RMUtil_FindSep(buf, 0, "", 0));
+        assert(!RMUtil_FindSep("abc", 3, "abcd", 4));
+        assert(!RMUtil_FindByte("abc", 0, 'a'));
+
+        // a small alphabet, with NUL and high bytes, so separators are frequent and overlap
+        const char alphabet[] = {'a', 'b', 'Z', '\0', (char)0xC1, ','};
+        for (int round = 0; round < 300; round++) {
+            size_t n = rand() % sizeof(buf);
+            size_t seplen = 1 + rand() % sizeof(sep);
+            int k = 2 + rand() % 4;
+            for (size_t i = 0; i < n; i++) {
+                buf[i] = alphabet[rand() % k];
+            }
+            for (size_t i = 0; i < seplen; i++) {
+                sep[i] = alphabet[rand() % k];
+            }
+            check_find(buf, n, sep, seplen);
+            // a separator that is surely there
+            if (n > seplen) {
+                size_t at = rand() % (n - seplen);
+                memcpy(sep, buf + at, seplen);
+                check_find(buf, n, sep, seplen);
+            }
+        }
+
+        // a rare first byte, so the SIMD kernels hand the search over to memchr, with decoys and a few matches
+        char sparse[1000];
+        for (int round = 0; round < 20; round++) {
+            memset(sparse, 'x', sizeof(sparse));
+            for (int i = 0; i < 4; i++) {
+                memcpy(sparse + rand() % (sizeof(sparse) - 3), i % 2 ? "<s" : "<s>", i % 2 ? 2 : 3);
+            }
+            check_find(sparse, sizeof(sparse), "<s>", 3);
+        }
+
+        // every byte value, around the letter ranges in particular
+        for (int i = 0; i < sizeof(buf); i++) {
+            buf[i] = (char)(i * 7 + f);
+        }
+        for (size_t n = 0; n <= sizeof(buf); n += 1 + n / 8) {
+            check_case(buf, n);
+        }
+        for (int c = 0; c < 256; c++) {
+            buf[0] = c;
+            check_case(buf, 1);
+        }
+    }
+    RMUtil_SetCPUFeatures(-1);
+
+    char s[] = "Hello, World! 123 [Brackets] `ticks` @at {braces}";
+    RMUtil_ASCIIToLower(s, strlen(s));
+    assert(!strcmp("hello, world! 123 [brackets] `ticks` @at {braces}", s));
+    RMUtil_ASCIIToUpper(s, strlen(s));
+    assert(!strcmp("HELLO, WORLD! 123 [BRACKETS] `TICKS` @AT {BRACES}", s));
+
+    printf("PASS!");
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include <stdio.h>
+#include <stdint.h>
+#include "chunked_vector.h"
+#include "assert.h"
+
+int main(int argc, char **argv) {
+
+    ChunkedVector *cv = NewChunkedVector(uint64_t, 100);
+    assert(Chunked_Vector_Size(cv) == 0);
+    int N = 10000;
+
+    for (int i = 0; i < N / 2; i++) {
+        Chunked_Vector_Put(cv, i, (uint64_t)i);
+    }
+    uint64_t *first = Chunked_Vector_GetPtr(cv, 0);
+    uint64_t *mid = Chunked_Vector_GetPtr(cv, 300);
+
+    for (int i = N / 2; i < N; i++) {
+        Chunked_Vector_Push(cv, (uint64_t)i);
+    }
+    assert(Chunked_Vector_Size(cv) == N);
+    // chunks of 128 elements
+    assert(Chunked_Vector_Cap(cv) >= N && Chunked_Vector_Cap(cv) % 128 == 0);
+
+    // growing does not move existing elements
+    assert(first == Chunked_Vector_GetPtr(cv, 0));
+    assert(mid == Chunked_Vector_GetPtr(cv, 300) && *mid == 300);
+
+    for (int i = 0; i < N; i++) {
+        uint64_t n;
+        assert(Chunked_Vector_Get(cv, i, &n) == 1);
+        assert(n == i);
+    }
+    assert(Chunked_Vector_Get(cv, N, NULL) == 0);
+    assert(Chunked_Vector_GetPtr(cv, N) == NULL);
+
+    // popped values are zeroed when a later put exposes them again
+    uint64_t n;
+    for (int i = 0; i < 200; i++) {
+        assert(Chunked_Vector_Pop(cv, &n) == 1);
+        assert(n == N - 1 - i);
+    }
+    Chunked_Vector_Put(cv, N, (uint64_t)42);
+    for (int i = N - 200; i < N; i++) {
+        assert(Chunked_Vector_Get(cv, i, &n) == 1 && n == 0);
+    }
+    assert(Chunked_Vector_Get(cv, N, &n) == 1 && n == 42);
+
+    while (Chunked_Vector_Pop(cv, NULL))
+        ;
+    assert(Chunked_Vector_Size(cv) == 0);
+    Chunked_Vector_ShrinkToFit(cv);
+    assert(Chunked_Vector_Cap(cv) == 0);
+    Chunked_Vector_Push(cv, (uint64_t)7);
+    assert(Chunked_Vector_Get(cv, 0, &n) == 1 && n == 7);
+
+    Chunked_Vector_Free(cv);
+    printf("PASS!");
+    return 0;
+}
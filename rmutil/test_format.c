@@ -0,0 +1,197 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <inttypes.h>
+#include "assert.h"
+#include "format.h"
+
+/* Reference shortest formatting with printf: the fewest %e digits that read back as v, laid out like
+ * RMUtil_FormatDouble, or always in decimal notation if fixed. At powers of 2 the interval of values that read back as
+ * v is wider above it, so the correctly rounded digits may not read back when their successor does */
+void format_ref(char *out, double v, int fixed) {
+    char e[64], mant[32];
+    uint64_t m = 0;
+    int exp = 0;
+    for (int digits = 1; digits <= 17; digits++) {
+        snprintf(e, sizeof(e), "%.*e", digits - 1, fabs(v));
+        m = 0;
+        for (char *p = e; *p != 'e'; p++) {
+            if (*p != '.')
+                m = m * 10 + *p - '0';
+        }
+        exp = atoi(strchr(e, 'e') + 1) - (digits - 1);
+        snprintf(e, sizeof(e), "%" PRIu64 "e%d", m, exp);
+        if (strtod(e, NULL) == fabs(v))
+            break;
+        snprintf(e, sizeof(e), "%" PRIu64 "e%d", ++m, exp);
+        if (strtod(e, NULL) == fabs(v))
+            break;
+    }
+    while (m % 10 == 0) {
+        m /= 10;
+        exp++;
+    }
+    int n = sprintf(mant, "%" PRIu64, m);
+    // exponent of the first digit
+    exp += n - 1;
+    if (v < 0)
+        *out++ = '-';
+
+    if (!fixed && (exp < -4 || exp >= 17)) {
+        *out++ = mant[0];
+        if (n > 1) {
+            *out++ = '.';
+            memcpy(out, mant + 1, n - 1);
+            out += n - 1;
+        }
+        sprintf(out, "e%c%02d", exp < 0 ? '-' : '+', abs(exp));
+        return;
+    }
+    if (exp < 0) {
+        *out++ = '0';
+        *out++ = '.';
+        for (int i = 0; i < -exp - 1; i++)
+            *out++ = '0';
+        memcpy(out, mant, n);
+        out += n;
+    } else {
+        for (int i = 0; i <= exp || i < n; i++) {
+            if (i == exp + 1)
+                *out++ = '.';
+            *out++ = i < n ? mant[i] : '0';
+        }
+    }
+    *out = '\0';
+}
+
+void check_double(double v) {
+    // zero has no shortest digits, and is checked on its own
+    if (v == 0)
+        return;
+    char buf[RMUTIL_FMT_DOUBLE_FIXED_SIZE], ref[RMUTIL_FMT_DOUBLE_FIXED_SIZE];
+    size_t len = RMUtil_FormatDouble(buf, v);
+    assert(len == strlen(buf) && len < RMUTIL_FMT_DOUBLE_SIZE);
+    format_ref(ref, v, 0);
+    if (strcmp(ref, buf)) {
+        fprintf(stderr, "%.17g: %s != %s\n", v, buf, ref);
+        assert(0);
+    }
+    assert(strtod(buf, NULL) == v);
+
+    len = RMUtil_FormatDoubleFixed(buf, v);
+    assert(len == strlen(buf) && len < RMUTIL_FMT_DOUBLE_FIXED_SIZE);
+    format_ref(ref, v, 1);
+    if (strcmp(ref, buf)) {
+        fprintf(stderr, "%.17g: %s != %s\n", v, buf, ref);
+        assert(0);
+    }
+    assert(strtod(buf, NULL) == v);
+}
+
+double random_bits() {
+    uint64_t bits = 0;
+    for (int i = 0; i < 4; i++) {
+        bits = bits << 16 | (rand() & 0xffff);
+    }
+    double v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+int main(int argc, char **argv) {
+    char buf[RMUTIL_FMT_DOUBLE_FIXED_SIZE], ref[32];
+
+    // integers, around every power of 10
+    int64_t ints[] = {0, 1, -1, 9, 10, 99, 100, INT64_MAX, INT64_MIN, INT32_MAX, INT32_MIN};
+    for (int i = 0; i < sizeof(ints) / sizeof(ints[0]); i++) {
+        sprintf(ref, "%" PRId64, ints[i]);
+        assert(strlen(ref) == RMUtil_FormatI64(buf, ints[i]) && !strcmp(ref, buf));
+    }
+    assert(20 == RMUtil_FormatU64(buf, UINT64_MAX) && !strcmp("18446744073709551615", buf));
+    for (uint64_t p = 1; p <= UINT64_MAX / 10; p *= 10) {
+        for (int64_t d = -1; d <= 1; d++) {
+            sprintf(ref, "%" PRIu64, p + d);
+            assert(strlen(ref) == RMUtil_FormatU64(buf, p + d) && !strcmp(ref, buf));
+            sprintf(ref, "%" PRId64, -(int64_t)(p + d));
+            assert(strlen(ref) == RMUtil_FormatI64(buf, -(int64_t)(p + d)) && !strcmp(ref, buf));
+        }
+    }
+    for (int i = 0; i < 100000; i++) {
+        double bits = random_bits();
+        int64_t v;
+        memcpy(&v, &bits, sizeof(v));
+        v >>= rand() % 64;
+        sprintf(ref, "%" PRId64, v);
+        assert(strlen(ref) == RMUtil_FormatI64(buf, v) && !strcmp(ref, buf));
+    }
+
+    // special values
+    struct {
+        double v;
+        const char *general, *fixed;
+    } cases[] = {
+        {0.0, "0", "0"},
+        {-0.0, "-0", "-0"},
+        {INFINITY, "inf", "inf"},
+        {-INFINITY, "-inf", "-inf"},
+        {NAN, "nan", "nan"},
+        {1.0, "1", "1"},
+        {0.1, "0.1", "0.1"},
+        {-1.5, "-1.5", "-1.5"},
+        {0.0001, "0.0001", "0.0001"},
+        {0.00001, "1e-05", "0.00001"},
+        {1e16, "10000000000000000", "10000000000000000"},
+        {1e17, "1e+17", "100000000000000000"},
+        {123456789012345680.0, "1.2345678901234568e+17", "123456789012345680"},
+        {1e100, "1e+100", NULL},
+        {5e-324, "5e-324", NULL},
+        {1.7976931348623157e308, "1.7976931348623157e+308", NULL},
+        {2.2250738585072014e-308, "2.2250738585072014e-308", NULL},
+        {9007199254740993.0, "9007199254740992", "9007199254740992"},
+        {0.3, "0.3", "0.3"},
+        {2.0 / 3, "0.6666666666666666", "0.6666666666666666"},
+    };
+    for (int i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        assert(strlen(cases[i].general) == RMUtil_FormatDouble(buf, cases[i].v));
+        assert(!strcmp(cases[i].general, buf));
+        if (cases[i].fixed) {
+            assert(strlen(cases[i].fixed) == RMUtil_FormatDoubleFixed(buf, cases[i].v));
+            assert(!strcmp(cases[i].fixed, buf));
+        }
+        if (isfinite(cases[i].v))
+            check_double(cases[i].v);
+    }
+
+    // the extremes of the fixed notation
+    assert(327 == RMUtil_FormatDoubleFixed(buf, -5e-324));
+    assert(!strncmp("-0.000", buf, 6) && !strcmp("5", buf + 326));
+    assert(310 == RMUtil_FormatDoubleFixed(buf, -1.7976931348623157e308));
+
+    // powers of 2 and 10, whose intervals are asymmetric or exact, and their neighbours
+    for (int e = -1074; e <= 1023; e++) {
+        double v = ldexp(1, e);
+        check_double(v);
+        check_double(nextafter(v, 0));
+        check_double(nextafter(v, INFINITY));
+    }
+    for (int e = -323; e <= 308; e++) {
+        char s[16];
+        sprintf(s, "1e%d", e);
+        double v = strtod(s, NULL);
+        check_double(v);
+        check_double(nextafter(v, 0));
+        check_double(nextafter(v, INFINITY));
+    }
+
+    // random bit patterns, and random short decimals
+    for (int i = 0; i < 20000; i++) {
+        double v = random_bits();
+        if (isfinite(v))
+            check_double(v);
+        check_double((rand() % 100000) / pow(10, rand() % 30 - 10));
+    }
+
+    printf("PASS!");
+    return 0;
+}
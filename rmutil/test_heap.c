@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <stdint.h>
 #include "heap.h"
 #include "assert.h"
 
@@ -8,6 +9,101 @@ int cmp(void *a, void *b) {
     return *__a - *__b;
 }
 
+/* Build a heap of n random ints with the given arity, by pushes or by Make_Heap_Arity, and check that popping
+ * everything leaves the range sorted */
+void testArity(int arity, size_t n, int push) {
+    Vector *v = NewVector(int, n);
+    for (size_t i = 0; i < n; i++) {
+        Vector_Push(v, rand() % 1000);
+        if (push)
+            Heap_Push_Arity(v, 0, v->top, cmp, arity);
+    }
+    if (!push)
+        Make_Heap_Arity(v, 0, v->top, cmp, arity);
+
+    for (size_t last = n; last > 0; last--) {
+        int top;
+        Vector_Get(v, 0, &top);
+        for (size_t i = 1; i < last; i++) {
+            int x;
+            Vector_Get(v, i, &x);
+            assert(x <= top);
+        }
+        Heap_Pop_Arity(v, 0, last, cmp, arity);
+        int popped;
+        Vector_Get(v, last - 1, &popped);
+        assert(popped == top);
+    }
+    for (size_t i = 1; i < n; i++) {
+        int a, b;
+        Vector_Get(v, i - 1, &a);
+        Vector_Get(v, i, &b);
+        assert(a <= b);
+    }
+    Vector_Free(v);
+}
+
+typedef struct {
+    uint64_t when;
+    int id;
+} timer;
+
+RMUTIL_HEAP_DECLARE(int, IntHeap, a < b)
+RMUTIL_HEAP_DECLARE(timer, TimerHeap, a.when > b.when)
+
+void testTypedHeap() {
+    // range primitives match the generic heap
+    int a[300];
+    Vector *v = NewVector(int, 300);
+    for (int i = 0; i < 300; i++) {
+        a[i] = rand() % 1000;
+        Vector_Push(v, a[i]);
+    }
+    IntHeap_MakeHeap(a, 300);
+    Make_Heap(v, 0, 300, cmp);
+    for (size_t last = 300; last > 0; last--) {
+        int top;
+        Vector_Get(v, 0, &top);
+        assert(a[0] == top);
+        IntHeap_PopHeap(a, last);
+        Heap_Pop(v, 0, last, cmp);
+        assert(a[last - 1] == top);
+    }
+    for (int i = 1; i < 300; i++) {
+        assert(a[i - 1] <= a[i]);
+    }
+    int max = -1;
+    for (int i = 0; i < 300; i++) {
+        a[i] = rand() % 1000;
+        max = a[i] > max ? a[i] : max;
+        IntHeap_PushHeap(a, i + 1);
+        assert(a[0] == max);
+    }
+    Vector_Free(v);
+
+    // the container is a min-heap on when
+    TimerHeap *h = NewTimerHeap(0);
+    timer t;
+    assert(!TimerHeap_Top(h, &t));
+    assert(!TimerHeap_Pop(h, &t));
+    for (int i = 0; i < 1000; i++) {
+        timer x = {(i * 7919) % 1000, i};
+        assert(i + 1 == TimerHeap_Push(h, x));
+    }
+    assert(1000 == TimerHeap_Size(h));
+    for (uint64_t i = 0; i < 1000; i++) {
+        assert(TimerHeap_Top(h, &t));
+        assert(i == t.when);
+        assert(TimerHeap_Pop(h, &t));
+        assert(i == t.when);
+        assert((t.id * 7919) % 1000 == t.when);
+    }
+    assert(0 == TimerHeap_Size(h));
+    TimerHeap_Push(h, t);
+    assert(TimerHeap_Pop(h, NULL));
+    TimerHeap_Free(h);
+}
+
 int main(int argc, char **argv) {
     int myints[] = {10, 20, 30, 5, 15};
     Vector *v = NewVector(int, 5);
@@ -32,6 +128,18 @@ int main(int argc, char **argv) {
     assert(99 == n);
 
     Vector_Free(v);
+
+    int arities[] = {2, 3, 4, 8};
+    size_t sizes[] = {1, 2, 5, 9, 64, 300};
+    for (int a = 0; a < 4; a++) {
+        for (int s = 0; s < 6; s++) {
+            testArity(arities[a], sizes[s], 0);
+            testArity(arities[a], sizes[s], 1);
+        }
+    }
+
+    testTypedHeap();
+
     printf("PASS!");
     return 0;
 }
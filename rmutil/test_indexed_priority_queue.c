@@ -0,0 +1,111 @@
+#include <stdio.h>
+#include "assert.h"
+#include "indexed_priority_queue.h"
+
+int cmp(void *i1, void *i2) {
+    int *__i1 = (int *)i1;
+    int *__i2 = (int *)i2;
+    return *__i1 - *__i2;
+}
+
+#define N 500
+
+/* Brute force model: the value of every live handle */
+int live[N * 2];
+int values[N * 2];
+
+/* Return the highest live value, or -1 */
+int model_max() {
+    int max = -1;
+    for (int h = 0; h < N * 2; h++) {
+        if (live[h] && values[h] > max)
+            max = values[h];
+    }
+    return max;
+}
+
+int main(int argc, char **argv) {
+    IndexedPriorityQueue *pq = NewIndexedPriorityQueue(int, 4, cmp);
+    assert(0 == Indexed_Priority_Queue_Size(pq));
+    int n;
+    size_t h;
+    assert(!Indexed_Priority_Queue_Top(pq, &n, &h));
+    assert(!Indexed_Priority_Queue_Pop(pq, &n));
+    assert(!Indexed_Priority_Queue_Contains(pq, 0));
+
+    size_t a = Indexed_Priority_Queue_Push(pq, 10);
+    size_t b = Indexed_Priority_Queue_Push(pq, 20);
+    size_t c = Indexed_Priority_Queue_Push(pq, 15);
+    assert(3 == Indexed_Priority_Queue_Size(pq));
+    assert(Indexed_Priority_Queue_Top(pq, &n, &h));
+    assert(20 == n && b == h);
+
+    // decrease the top, increase another
+    assert(Indexed_Priority_Queue_UpdateKey(pq, b, 5));
+    assert(Indexed_Priority_Queue_Top(pq, &n, &h));
+    assert(15 == n && c == h);
+    assert(Indexed_Priority_Queue_UpdateKey(pq, a, 30));
+    assert(Indexed_Priority_Queue_Top(pq, &n, &h));
+    assert(30 == n && a == h);
+
+    assert(Indexed_Priority_Queue_Remove(pq, a, &n));
+    assert(30 == n);
+    assert(!Indexed_Priority_Queue_Contains(pq, a));
+    assert(!Indexed_Priority_Queue_Remove(pq, a, NULL));
+    assert(!Indexed_Priority_Queue_UpdateKey(pq, a, 1));
+    assert(Indexed_Priority_Queue_Get(pq, b, &n));
+    assert(5 == n);
+
+    assert(Indexed_Priority_Queue_Pop(pq, &n));
+    assert(15 == n);
+    assert(!Indexed_Priority_Queue_Contains(pq, c));
+    assert(Indexed_Priority_Queue_Pop(pq, NULL));
+    assert(0 == Indexed_Priority_Queue_Size(pq));
+    Indexed_Priority_Queue_Free(pq);
+
+    // random operations against the model
+    pq = NewIndexedPriorityQueue(int, 0, cmp);
+    size_t size = 0;
+    for (int i = 0; i < 20000; i++) {
+        int op = rand() % 4;
+        if (op == 0 && size < N) {
+            int x = rand() % 1000;
+            h = Indexed_Priority_Queue_Push(pq, x);
+            assert(h < N * 2);
+            assert(!live[h]);
+            live[h] = 1;
+            values[h] = x;
+            size++;
+        } else if (op == 1 && size > 0) {
+            assert(Indexed_Priority_Queue_Top(pq, NULL, &h));
+            assert(Indexed_Priority_Queue_Pop(pq, &n));
+            assert(model_max() == n);
+            assert(live[h] && values[h] == n);
+            live[h] = 0;
+            size--;
+        } else {
+            h = rand() % (N * 2);
+            assert(Indexed_Priority_Queue_Contains(pq, h) == live[h]);
+            if (op == 2) {
+                int x = rand() % 1000;
+                assert(Indexed_Priority_Queue_UpdateKey(pq, h, x) == live[h]);
+                values[h] = live[h] ? x : values[h];
+            } else if (live[h]) {
+                assert(Indexed_Priority_Queue_Remove(pq, h, &n));
+                assert(values[h] == n);
+                live[h] = 0;
+                size--;
+            }
+        }
+        assert(size == Indexed_Priority_Queue_Size(pq));
+        if (size) {
+            assert(Indexed_Priority_Queue_Top(pq, &n, &h));
+            assert(model_max() == n);
+            assert(live[h] && values[h] == n);
+        }
+    }
+    Indexed_Priority_Queue_Free(pq);
+
+    printf("PASS!");
+    return 0;
+}
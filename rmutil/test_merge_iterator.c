@@ -0,0 +1,107 @@
+#include <stdio.h>
+#include "assert.h"
+#include "merge_iterator.h"
+#include "sort.h"
+
+typedef struct {
+    int key;
+    int source;
+} item;
+
+int cmp(void *a, void *b) {
+    return ((item *)a)->key - ((item *)b)->key;
+}
+
+// order by key, then by source, which is the order of a stable merge
+int cmp_stable(void *a, void *b) {
+    item *x = a, *y = b;
+    return x->key != y->key ? x->key - y->key : x->source - y->source;
+}
+
+/* A generated source: count from ctx[0] to ctx[1] */
+int range_next(void *ctx, void *elem) {
+    int *r = ctx;
+    if (r[0] >= r[1])
+        return 0;
+    item it = {r[0]++, -1};
+    memcpy(elem, &it, sizeof(item));
+    return 1;
+}
+
+/* Merge k random sorted vectors, and compare with sorting their concatenation */
+void testMerge(int k, size_t limit) {
+    Vector *sources[k];
+    Vector *all = NewVector(item, 0);
+    MergeIterator *it = NewMergeIterator(item, cmp);
+    for (int s = 0; s < k; s++) {
+        sources[s] = NewVector(item, 0);
+        size_t n = rand() % 4 == 0 ? 0 : rand() % 200;
+        for (size_t i = 0; i < n; i++) {
+            item x = {rand() % 100, s};
+            __vector_PushPtr(sources[s], &x);
+        }
+        Vector_Sort(sources[s], 0, n, cmp_stable);
+        Vector_Append(all, sources[s]);
+        assert(Merge_Iterator_AddVector(it, sources[s]));
+    }
+    Vector_Sort(all, 0, all->top, cmp_stable);
+    Merge_Iterator_SetLimit(it, limit);
+
+    size_t expected = limit && limit < all->top ? limit : all->top;
+    item x;
+    for (size_t i = 0; i < expected; i++) {
+        assert(Merge_Iterator_Next(it, &x));
+        item *want = Vector_GetPtr(all, i);
+        assert(want->key == x.key && want->source == x.source);
+    }
+    assert(!Merge_Iterator_Next(it, &x));
+    assert(!Merge_Iterator_Next(it, &x));
+
+    // no more sources once started
+    assert(!Merge_Iterator_AddVector(it, all));
+    Merge_Iterator_Free(it);
+    for (int s = 0; s < k; s++) {
+        Vector_Free(sources[s]);
+    }
+    Vector_Free(all);
+}
+
+int main(int argc, char **argv) {
+    item x;
+
+    // no sources
+    MergeIterator *it = NewMergeIterator(item, cmp);
+    assert(!Merge_Iterator_Next(it, &x));
+    Merge_Iterator_Free(it);
+
+    // callback sources, mixed with a vector
+    it = NewMergeIterator(item, cmp);
+    int a[] = {0, 5}, b[] = {3, 8};
+    Vector *v = NewVector(item, 0);
+    __vector_PushPtr(v, &(item){4, 7});
+    __vector_PushPtr(v, &(item){10, 7});
+    Vector *ints = NewVector(int, 0);
+    assert(!Merge_Iterator_AddVector(it, ints));
+    Vector_Free(ints);
+    assert(Merge_Iterator_AddSource(it, range_next, a));
+    assert(Merge_Iterator_AddSource(it, range_next, b));
+    assert(Merge_Iterator_AddVector(it, v));
+    int expected[] = {0, 1, 2, 3, 3, 4, 4, 4, 5, 6, 7, 10};
+    for (int i = 0; i < 12; i++) {
+        assert(Merge_Iterator_Next(it, &x));
+        assert(expected[i] == x.key);
+    }
+    assert(!Merge_Iterator_Next(it, &x));
+    Merge_Iterator_Free(it);
+    Vector_Free(v);
+
+    int ks[] = {1, 2, 3, 5, 8, 13, 50};
+    for (int k = 0; k < sizeof(ks) / sizeof(ks[0]); k++) {
+        testMerge(ks[k], 0);
+        testMerge(ks[k], 1);
+        testMerge(ks[k], 37);
+    }
+
+    printf("PASS!");
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include "assert.h"
+#include "minmax_heap.h"
+
+int cmp(void *i1, void *i2) {
+    int *__i1 = (int *)i1;
+    int *__i2 = (int *)i2;
+    return *__i1 - *__i2;
+}
+
+/* Brute force model: a count of every value */
+#define VALUES 200
+int counts[VALUES];
+
+int model_min() {
+    for (int x = 0; x < VALUES; x++) {
+        if (counts[x])
+            return x;
+    }
+    return -1;
+}
+
+int model_max() {
+    for (int x = VALUES - 1; x >= 0; x--) {
+        if (counts[x])
+            return x;
+    }
+    return -1;
+}
+
+int main(int argc, char **argv) {
+    MinMaxHeap *h = NewMinMaxHeap(int, 0, cmp);
+    int n;
+    assert(0 == MinMax_Heap_Size(h));
+    assert(!MinMax_Heap_Min(h, &n));
+    assert(!MinMax_Heap_Max(h, &n));
+    assert(!MinMax_Heap_PopMin(h, &n));
+    assert(!MinMax_Heap_PopMax(h, &n));
+
+    assert(1 == MinMax_Heap_Push(h, 5));
+    assert(MinMax_Heap_Min(h, &n) && 5 == n);
+    assert(MinMax_Heap_Max(h, &n) && 5 == n);
+    MinMax_Heap_Push(h, 1);
+    MinMax_Heap_Push(h, 9);
+    MinMax_Heap_Push(h, 7);
+    MinMax_Heap_Push(h, 3);
+    assert(5 == MinMax_Heap_Size(h));
+    assert(MinMax_Heap_Min(h, &n) && 1 == n);
+    assert(MinMax_Heap_Max(h, &n) && 9 == n);
+    assert(MinMax_Heap_PopMax(h, &n) && 9 == n);
+    assert(MinMax_Heap_PopMin(h, &n) && 1 == n);
+    assert(MinMax_Heap_PopMax(h, NULL));
+    assert(MinMax_Heap_Max(h, &n) && 5 == n);
+    assert(MinMax_Heap_Min(h, &n) && 3 == n);
+    MinMax_Heap_Free(h);
+
+    // random operations against the model
+    h = NewMinMaxHeap(int, 0, cmp);
+    size_t size = 0;
+    for (int i = 0; i < 100000; i++) {
+        int op = rand() % 5;
+        if (op < 2 || size == 0) {
+            int x = rand() % VALUES;
+            counts[x]++;
+            assert(++size == MinMax_Heap_Push(h, x));
+        } else if (op == 2) {
+            assert(MinMax_Heap_PopMin(h, &n));
+            assert(model_min() == n);
+            counts[n]--;
+            size--;
+        } else if (op == 3) {
+            assert(MinMax_Heap_PopMax(h, &n));
+            assert(model_max() == n);
+            counts[n]--;
+            size--;
+        }
+        assert(size == MinMax_Heap_Size(h));
+        if (size) {
+            assert(MinMax_Heap_Min(h, &n) && model_min() == n);
+            assert(MinMax_Heap_Max(h, &n) && model_max() == n);
+        }
+    }
+
+    // draining from both ends meets in the middle
+    while (MinMax_Heap_Size(h) > 1) {
+        int lo, hi;
+        assert(MinMax_Heap_PopMin(h, &lo));
+        assert(MinMax_Heap_PopMax(h, &hi));
+        assert(lo <= hi);
+        assert(lo == model_min());
+        counts[lo]--;
+        assert(hi == model_max());
+        counts[hi]--;
+    }
+    MinMax_Heap_Free(h);
+
+    printf("PASS!");
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include <stdio.h>
+#include "assert.h"
+#include "multi_queue.h"
+
+int cmp(void *i1, void *i2) {
+    int *__i1 = (int *)i1;
+    int *__i2 = (int *)i2;
+    return *__i1 - *__i2;
+}
+
+#define THREADS 4
+#define PER_THREAD 20000
+
+MultiQueue *mq;
+char seen[THREADS * PER_THREAD];
+
+/* Push a disjoint range of values, popping one for every two pushes */
+void *worker(void *arg) {
+    int base = (int)(size_t)arg * PER_THREAD;
+    for (int i = 0; i < PER_THREAD; i++) {
+        Multi_Queue_Push(mq, base + i);
+        int n;
+        if (i % 2 && Multi_Queue_Pop(mq, &n)) {
+            assert(n >= 0 && n < THREADS * PER_THREAD);
+            assert(!__atomic_exchange_n(&seen[n], 1, __ATOMIC_RELAXED));
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, char **argv) {
+    mq = NewMultiQueue(int, 8, cmp);
+    int n;
+    assert(0 == Multi_Queue_Size(mq));
+    assert(!Multi_Queue_Pop(mq, &n));
+
+    // a single thread gets elements close to the top. The bound is statistical, so fix the seed to make it
+    // deterministic rather than dependent on the address the generator is otherwise seeded from
+    Multi_Queue_SeedThread(42);
+    for (int i = 0; i < 1000; i++) {
+        Multi_Queue_Push(mq, i);
+    }
+    assert(1000 == Multi_Queue_Size(mq));
+    long sum = 0;
+    for (int i = 0; i < 100; i++) {
+        assert(Multi_Queue_Pop(mq, &n));
+        sum += n;
+    }
+    assert(sum / 100 > 900);
+    while (Multi_Queue_Pop(mq, &n))
+        ;
+    assert(0 == Multi_Queue_Size(mq));
+
+    // concurrent pushes and pops lose and duplicate nothing
+    pthread_t threads[THREADS];
+    for (size_t t = 0; t < THREADS; t++) {
+        pthread_create(&threads[t], NULL, worker, (void *)t);
+    }
+    for (int t = 0; t < THREADS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    while (Multi_Queue_Pop(mq, &n)) {
+        assert(!seen[n]);
+        seen[n] = 1;
+    }
+    for (int i = 0; i < THREADS * PER_THREAD; i++) {
+        assert(seen[i]);
+    }
+    assert(0 == Multi_Queue_Size(mq));
+    Multi_Queue_Free(mq);
+
+    printf("PASS!");
+    return 0;
+}
@@ -0,0 +1,148 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <ctype.h>
+#include <math.h>
+#include <limits.h>
+#include <stdint.h>
+#include "assert.h"
+#include "parse.h"
+
+/* Reference long long parsing with strtoll() and the rules of Redis string2ll() */
+int ll_ref(const char *s, size_t len, long long *value) {
+    char buf[64], *eptr;
+    if (len == 0 || len > 20 || isspace((unsigned char)s[0]) || s[0] == '+')
+        return 0;
+    // no leading zeros, except for "0", and no "-0"
+    if (len > 1 && (s[0] == '0' || (s[0] == '-' && s[1] == '0')))
+        return 0;
+    memcpy(buf, s, len);
+    buf[len] = '\0';
+    errno = 0;
+    long long v = strtoll(buf, &eptr, 10);
+    if (eptr != buf + len || errno == ERANGE)
+        return 0;
+    *value = v;
+    return 1;
+}
+
+/* Reference double parsing, as Redis getDoubleFromObject() does */
+int d_ref(const char *s, size_t len, double *value) {
+    char buf[256], *eptr;
+    if (len == 0 || isspace((unsigned char)s[0]))
+        return 0;
+    memcpy(buf, s, len);
+    buf[len] = '\0';
+    errno = 0;
+    double d = strtod(buf, &eptr);
+    if (eptr != buf + len || (errno == ERANGE && (d == HUGE_VAL || d == -HUGE_VAL || d == 0)) || isnan(d))
+        return 0;
+    *value = d;
+    return 1;
+}
+
+void check(const char *s, size_t len) {
+    long long l1 = 42, l2 = 42;
+    int ok = ll_ref(s, len, &l1);
+    if (ok != RMUtil_ParseLongLong(s, len, &l2) || l1 != l2) {
+        fprintf(stderr, "long long '%.*s'\n", (int)len, s);
+        assert(0);
+    }
+    double d1 = 42, d2 = 42;
+    ok = d_ref(s, len, &d1);
+    if (ok != RMUtil_ParseDouble(s, len, &d2) || memcmp(&d1, &d2, sizeof(double))) {
+        fprintf(stderr, "double '%.*s' %d %.17g %.17g\n", (int)len, s, ok, d1, d2);
+        assert(0);
+    }
+}
+
+void checks(const char *s) {
+    check(s, strlen(s));
+}
+
+/* A random string made mostly of number characters */
+size_t random_number(char *buf) {
+    static const char chars[] = "0123456789000999-+.eE";
+    size_t len = 1 + rand() % 30;
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = rand() % 4 ? '0' + rand() % 10 : chars[rand() % (sizeof(chars) - 1)];
+    }
+    return len;
+}
+
+int main(int argc, char **argv) {
+    const char *cases[] = {
+        "0", "-0", "00", "01", "1", "-1", "+1", " 1", "1 ", "", "-", "12345678", "123456789", "1234567890123456789",
+        "9223372036854775807", "9223372036854775808", "-9223372036854775808", "-9223372036854775809",
+        "18446744073709551616", "99999999999999999999", "-99999999999999999999", "123a", "1.5", ".5", "5.", ".",
+        "-.5e-3", "1e", "1e+", "e5", "1e5", "1E-5", "1e308", "1.7976931348623157e308", "1.7976931348623159e308",
+        "1e309", "-1e309", "2.2250738585072011e-308", "4.9e-324", "2.4e-324", "2.5e-324", "1e-400", "0e999999999999",
+        "0.000000000000000000000000000000000000001", "123456789012345678901234567890", "0x1p3", "0X10", "inf",
+        "-inf", "infinity", "nan", "-nan", "9007199254740993", "9007199254740992.5", "3.14159265358979323846",
+        "1.00000000000000011102230246251565404236316680908203125",
+        "1.00000000000000011102230246251565404236316680908203124", "7.2057594037927933e16", "1e22", "1e23",
+        "8.98846567431158e307", "0.1", "0.2", "0.3", "100000000000000000000000", "1.0e-1", "000000.5e1",
+    };
+    for (int i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        checks(cases[i]);
+    }
+
+    long long l;
+    double d;
+    assert(RMUtil_ParseLongLong("-9223372036854775808", 20, &l) && l == LLONG_MIN);
+    assert(RMUtil_ParseLongLong("9223372036854775807", 19, &l) && l == LLONG_MAX);
+    assert(RMUtil_ParseDouble("0.1", 3, &d) && d == 0.1);
+    // no terminator needed
+    assert(RMUtil_ParseLongLong("12345", 3, &l) && l == 123);
+    assert(RMUtil_ParseDouble("1.5e3", 3, &d) && d == 1.5);
+    char nan[] = {'n', 'a', 'n'};
+    assert(!RMUtil_ParseDouble(nan, 3, &d));
+
+    // every integer length, around the powers of 10
+    char buf[64];
+    for (long long p = 1; p <= LLONG_MAX / 10; p *= 10) {
+        for (long long v = p - 2; v <= p + 2; v++) {
+            sprintf(buf, "%lld", v);
+            checks(buf);
+            sprintf(buf, "%lld", -v);
+            checks(buf);
+        }
+    }
+
+    // the shortest and the full representation of random doubles
+    for (int i = 0; i < 100000; i++) {
+        uint64_t bits = 0;
+        for (int j = 0; j < 4; j++) {
+            bits = bits << 16 | (rand() & 0xffff);
+        }
+        memcpy(&d, &bits, sizeof(d));
+        for (int digits = 15; digits <= 17; digits++) {
+            sprintf(buf, "%.*g", digits, d);
+            checks(buf);
+        }
+        sprintf(buf, "%lld", (long long)bits >> (rand() % 64));
+        checks(buf);
+        sprintf(buf, "%d.%de%d", rand(), rand(), rand() % 700 - 350);
+        checks(buf);
+    }
+
+    // long inputs go to strtod() through a heap copy, with no length limit, as in Redis
+    for (size_t zeros = 250; zeros <= 8000; zeros *= 4) {
+        char *s = malloc(zeros + 16);
+        int len = sprintf(s, "1%0*de-%zu", (int)zeros, 0, zeros);
+        assert(RMUtil_ParseDouble(s, len, &d) && d == 1);
+        s[len++] = 'x';
+        assert(!RMUtil_ParseDouble(s, len, &d));
+        free(s);
+    }
+
+    // random mixes of digits and number characters
+    for (int i = 0; i < 200000; i++) {
+        size_t len = random_number(buf);
+        check(buf, len);
+    }
+
+    printf("PASS!");
+    return 0;
+}
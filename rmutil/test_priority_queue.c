@@ -1,4 +1,4 @@
-#include <printf.h>
+#include <stdio.h>
 #include "assert.h"
 #include "priority_queue.h"
 
@@ -32,6 +32,73 @@ int main(int argc, char **argv) {
     assert(15 == n);
 
     Priority_Queue_Free(pq);
+
+    pq = NewPriorityQueueArity(int, 0, cmp, 4);
+    for (int i = 0; i < 1000; i++) {
+        Priority_Queue_Push(pq, (i * 7919) % 1000);
+    }
+    for (int i = 999; i >= 0; i--) {
+        Priority_Queue_Top(pq, &n);
+        assert(i == n);
+        Priority_Queue_Pop(pq);
+    }
+    assert(0 == Priority_Queue_Size(pq));
+    Priority_Queue_Free(pq);
+
+    // batches small enough to sift up, and large enough to rebuild
+    int batch[1000];
+    for (int i = 0; i < 1000; i++) {
+        batch[i] = (i * 7919) % 1000;
+    }
+    pq = NewPriorityQueueArity(int, 0, cmp, 4);
+    assert(1000 == Priority_Queue_PushMany(pq, batch, 1000));
+    assert(1003 == Priority_Queue_PushMany(pq, (int[]){5000, -1, 3000}, 3));
+    assert(1003 == Priority_Queue_PushMany(pq, NULL, 0));
+
+    PriorityQueue *other = NewPriorityQueue(int, 0, cmp);
+    Priority_Queue_Push(other, 4000);
+    Priority_Queue_Push(other, 2000);
+    assert(Priority_Queue_Merge(pq, other));
+    assert(2 == Priority_Queue_Size(other));
+    assert(1005 == Priority_Queue_Size(pq));
+    PriorityQueue *wide = NewPriorityQueue(long long, 0, cmp);
+    assert(!Priority_Queue_Merge(pq, wide));
+    Priority_Queue_Free(wide);
+
+    int expected[] = {5000, 4000, 3000, 2000};
+    for (int i = 0; i < 4; i++) {
+        Priority_Queue_Top(pq, &n);
+        assert(expected[i] == n);
+        Priority_Queue_Pop(pq);
+    }
+    for (int i = 999; i >= -1; i--) {
+        Priority_Queue_Top(pq, &n);
+        assert(i == n);
+        Priority_Queue_Pop(pq);
+    }
+    assert(0 == Priority_Queue_Size(pq));
+
+    // merging a large queue into a small one rebuilds the heap
+    assert(Priority_Queue_PushMany(other, batch, 1000));
+    assert(Priority_Queue_Merge(pq, other));
+    assert(1002 == Priority_Queue_Size(pq));
+    Priority_Queue_Top(pq, &n);
+    assert(4000 == n);
+    Priority_Queue_Free(other);
+
+    // merging a queue into itself duplicates every element, even when it has to grow
+    Vector_ShrinkToFit(pq->v);
+    assert(Priority_Queue_Merge(pq, pq));
+    assert(2004 == Priority_Queue_Size(pq));
+    for (int i = 0; i < 2; i++) {
+        Priority_Queue_Top(pq, &n);
+        assert(4000 == n);
+        Priority_Queue_Pop(pq);
+    }
+    Priority_Queue_Top(pq, &n);
+    assert(2000 == n);
+    Priority_Queue_Free(pq);
+
     printf("PASS!");
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include <stdio.h>
+#include "assert.h"
+#include "radix_heap.h"
+#include "priority_queue.h"
+
+typedef struct {
+    uint64_t key;
+    int id;
+} entry;
+
+// smallest key on top, ties broken by id so that the order is total
+int cmp(void *a, void *b) {
+    entry *x = a, *y = b;
+    if (x->key != y->key)
+        return x->key > y->key ? -1 : 1;
+    return (x->id > y->id) - (x->id < y->id);
+}
+
+int main(int argc, char **argv) {
+    RadixHeap *rh = NewRadixHeap(int);
+    uint64_t key;
+    int n;
+    assert(0 == Radix_Heap_Size(rh));
+    assert(!Radix_Heap_Top(rh, &key, &n));
+    assert(!Radix_Heap_Pop(rh, &key, &n));
+
+    assert(Radix_Heap_Push(rh, 10, 1));
+    assert(Radix_Heap_Push(rh, 3, 2));
+    assert(Radix_Heap_Push(rh, UINT64_MAX, 3));
+    assert(Radix_Heap_Push(rh, 3, 4));
+    assert(4 == Radix_Heap_Size(rh));
+
+    assert(Radix_Heap_Pop(rh, &key, &n));
+    assert(3 == key && (2 == n || 4 == n));
+    assert(Radix_Heap_Top(rh, &key, NULL));
+    assert(3 == key);
+    // keys below the last one returned are rejected
+    assert(!Radix_Heap_Push(rh, 2, 5));
+    assert(Radix_Heap_Push(rh, 3, 5));
+    assert(Radix_Heap_Pop(rh, &key, NULL));
+    assert(Radix_Heap_Pop(rh, &key, NULL));
+    assert(3 == key);
+    assert(Radix_Heap_Pop(rh, &key, &n));
+    assert(10 == key && 1 == n);
+    assert(Radix_Heap_Pop(rh, &key, &n));
+    assert(UINT64_MAX == key && 3 == n);
+    assert(0 == Radix_Heap_Size(rh));
+    Radix_Heap_Free(rh);
+
+    // no payload
+    rh = __newRadixHeapSize(0);
+    assert(__radix_Heap_PushPtr(rh, 7, NULL));
+    assert(Radix_Heap_Pop(rh, &key, NULL));
+    assert(7 == key);
+    Radix_Heap_Free(rh);
+
+    // a monotone workload, like a simulation clock, against a priority queue
+    rh = NewRadixHeap(entry);
+    PriorityQueue *pq = NewPriorityQueue(entry, 0, cmp);
+    uint64_t now = 0;
+    for (int i = 0; i < 50000; i++) {
+        if (rand() % 3 && Priority_Queue_Size(pq) < 5000) {
+            uint64_t delay = rand() % 4 == 0 ? rand() % 100 : ((uint64_t)rand() << (rand() % 30));
+            entry e = {now + delay, i};
+            assert(__radix_Heap_PushPtr(rh, e.key, &e));
+            __priority_Queue_PushPtr(pq, &e);
+        } else if (Priority_Queue_Size(pq)) {
+            entry expected, got;
+            Priority_Queue_Top(pq, &expected);
+            Priority_Queue_Pop(pq);
+            assert(Radix_Heap_Pop(rh, &key, &got));
+            // entries with equal keys may come out in any order
+            assert(expected.key == key && got.key == key);
+            now = key;
+        }
+        assert(Priority_Queue_Size(pq) == Radix_Heap_Size(rh));
+    }
+    Priority_Queue_Free(pq);
+    Radix_Heap_Free(rh);
+
+    printf("PASS!");
+    return 0;
+}
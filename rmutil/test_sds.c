@@ -0,0 +1,236 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <wchar.h>
+#include "assert.h"
+#include "sds.h"
+#include "sdsalloc.h"
+
+// from alloc.h, whose module API definitions would clash with the ones of alloc.o
+extern const sdsAllocator RMUtil_SDSAllocator;
+void RMUTil_InitAlloc();
+
+/* An allocator counting the live allocations */
+long live = 0, total = 0;
+
+void *countMalloc(void *ctx, size_t size) {
+    live++;
+    total++;
+    return malloc(size);
+}
+
+void *countRealloc(void *ctx, void *ptr, size_t size) {
+    if (!ptr) {
+        live++;
+        total++;
+    }
+    return realloc(ptr, size);
+}
+
+void countFree(void *ctx, void *ptr) {
+    if (ptr)
+        live--;
+    free(ptr);
+}
+
+const sdsAllocator countAllocator = {countMalloc, countRealloc, countFree, NULL};
+
+/* Build, grow, split and free strings with the current allocator */
+void useStrings() {
+    sds s = sdsnew("a,b");
+    for (int i = 0; i < 200; i++) {
+        s = sdscatfmt(s, ",%i", i);
+    }
+    sds t = sdsdup(s);
+    s = sdscatprintf(s, "%s", "!");
+    int count;
+    sds *tokens = sdssplitlen(t, sdslen(t), ",", 1, &count);
+    assert(202 == count && !strcmp("199", tokens[201]));
+    sdsfreesplitres(tokens, count);
+    t = sdsRemoveFreeSpace(t);
+    assert(0 == sdsavail(t));
+    assert(!strncmp(s, t, sdslen(t)) && sdslen(s) == sdslen(t) + 1);
+    sdsfree(s);
+    sdsfree(t);
+}
+
+typedef struct {
+    sds *tokens;
+    int count;
+    int seen;
+    int stopAt;
+} splitCtx;
+
+/* Check each callback token against the allocated split */
+int checkToken(void *ctx, const char *tok, size_t len) {
+    splitCtx *c = ctx;
+    assert(c->seen < c->count);
+    assert(len == sdslen(c->tokens[c->seen]));
+    assert(!memcmp(tok, c->tokens[c->seen], len));
+    c->seen++;
+    return c->seen != c->stopAt;
+}
+
+/* Split s with every API and check they agree */
+void testSplit(const char *s, size_t len, const char *sep, size_t seplen) {
+    int count;
+    sds *tokens = sdssplitlen(s, len, sep, seplen, &count);
+    assert(tokens);
+
+    sdssplititer it;
+    sdsslice tok;
+    int n = 0;
+    sdssplitinit(&it, s, len, sep, seplen);
+    while (sdssplitnext(&it, &tok)) {
+        assert(n < count);
+        assert(tok.ptr >= s && tok.ptr + tok.len <= s + len);
+        assert(tok.len == sdslen(tokens[n]));
+        assert(!memcmp(tok.ptr, tokens[n], tok.len));
+        n++;
+    }
+    assert(n == count);
+    assert(!sdssplitnext(&it, &tok));
+
+    splitCtx ctx = {tokens, count, 0, 0};
+    assert(count == sdssplitcb(s, len, sep, seplen, checkToken, &ctx));
+    assert(ctx.seen == count);
+    if (count > 1) {
+        ctx = (splitCtx){tokens, count, 0, 2};
+        assert(2 == sdssplitcb(s, len, sep, seplen, checkToken, &ctx));
+    }
+    sdsfreesplitres(tokens, count);
+}
+
+int main(int argc, char **argv) {
+    int count;
+    sds *tokens = sdssplitlen("foo_-_bar", 9, "_-_", 3, &count);
+    assert(2 == count);
+    assert(!strcmp("foo", tokens[0]) && !strcmp("bar", tokens[1]));
+    sdsfreesplitres(tokens, count);
+
+    tokens = sdssplitlen(",a,,b,", 6, ",", 1, &count);
+    assert(5 == count);
+    const char *expected[] = {"", "a", "", "b", ""};
+    for (int i = 0; i < 5; i++) {
+        assert(!strcmp(expected[i], tokens[i]));
+    }
+    sdsfreesplitres(tokens, count);
+
+    tokens = sdssplitlen("", 0, ",", 1, &count);
+    assert(tokens && 0 == count);
+    sdsfreesplitres(tokens, count);
+    assert(!sdssplitlen("a", 1, "", 0, &count));
+
+    // slices point into the source and are not terminated
+    const char *csv = "12,345,6789";
+    sdssplititer it;
+    sdsslice tok;
+    sdssplitinit(&it, csv, strlen(csv), ",", 1);
+    assert(sdssplitnext(&it, &tok) && tok.ptr == csv && tok.len == 2);
+    assert(sdssplitnext(&it, &tok) && tok.ptr == csv + 3 && tok.len == 3);
+    assert(sdssplitnext(&it, &tok) && tok.ptr == csv + 7 && tok.len == 4);
+    assert(!sdssplitnext(&it, &tok));
+
+    // no tokens for an empty string or separator
+    sdssplitinit(&it, csv, 0, ",", 1);
+    assert(!sdssplitnext(&it, &tok));
+    sdssplitinit(&it, csv, strlen(csv), "", 0);
+    assert(!sdssplitnext(&it, &tok));
+
+    testSplit("aaaaa", 5, "aa", 2);
+    testSplit("abab", 4, "abab", 4);
+    testSplit("aba", 3, "abab", 4);
+    testSplit("a\0b\0c", 5, "\0", 1);
+
+    // random strings over a small alphabet, so separators are frequent and overlap
+    char buf[300];
+    char sep[4];
+    for (int i = 0; i < 2000; i++) {
+        size_t len = rand() % sizeof(buf);
+        size_t seplen = 1 + rand() % sizeof(sep);
+        for (size_t j = 0; j < len; j++) {
+            buf[j] = 'a' + rand() % 3;
+        }
+        for (size_t j = 0; j < seplen; j++) {
+            sep[j] = 'a' + rand() % 3;
+        }
+        testSplit(buf, len, sep, seplen);
+    }
+
+    // formatting
+    sds arg = sdsnew("sds");
+    sds s = sdscatfmt(sdsempty(), "%i %I %u %U %s %S %g %f %%", -5, (long long)INT64_MIN, 7u,
+                      (unsigned long long)UINT64_MAX, "str", arg, 0.1, 1e21);
+    assert(!strcmp("-5 -9223372036854775808 7 18446744073709551615 str sds 0.1 1000000000000000000000 %", s));
+    assert(sdslen(s) == strlen(s));
+    sdsfree(arg);
+    sdsfree(s);
+    s = sdscatfmt(sdsnew("x"), "%g|%g|%g|%f", 1e100, -2.5e-7, 1.0 / 3, -0.5);
+    assert(!strcmp("x1e+100|-2.5e-07|0.3333333333333333|-0.5", s));
+    sdsfree(s);
+    s = sdsfromlonglong(LLONG_MIN);
+    assert(!strcmp("-9223372036854775808", s));
+    sdsfree(s);
+
+    // printf output longer than the static buffer, and arguments pointing into the string
+    s = sdscatprintf(sdsnew("ab"), "%0*d", 5000, 7);
+    assert(5002 == sdslen(s) && s[5001] == '7' && s[2] == '0' && !s[5002]);
+    sdsrange(s, 0, 2);
+    s = sdscatprintf(s, "%s-%s", s, s);
+    assert(!strcmp("ab0ab0-ab0", s));
+    sdsfree(s);
+    s = sdscatprintf(sdsempty(), "%c%c", 'a', 0);
+    assert(2 == sdslen(s));
+    // an encoding error, a wide character outside of ASCII in the C locale, leaves s unchanged
+    s = sdscatprintf(s, "%lc", (wint_t)0x100);
+    assert(s && 2 == sdslen(s));
+    sdsfree(s);
+
+    // the process wide allocator
+    sdsSetAllocator(&countAllocator);
+    assert(sdsGetAllocator() == &countAllocator);
+    useStrings();
+    assert(0 == live && total > 0);
+
+    // a thread allocator, nested over the process one
+    sdsArena *arena = sdsArenaNew(1024, NULL);
+    assert(1 == live);
+    const sdsAllocator *prev = sdsUseAllocator(sdsArenaAllocator(arena));
+    assert(NULL == prev && sdsGetAllocator() == sdsArenaAllocator(arena));
+    long before = total;
+    for (int round = 0; round < 3; round++) {
+        useStrings();
+        // strings longer than the chunks
+        sds big = sdsgrowzero(sdsempty(), 5000);
+        sds small = sdsnew("small");
+        big = sdscat(big, "x");
+        assert(5001 == sdslen(big) && 'x' == big[5000] && !strcmp("small", small));
+        // no frees needed
+        sdsArenaReset(arena);
+    }
+    assert(sdsUseAllocator(prev) == sdsArenaAllocator(arena));
+    assert(sdsGetAllocator() == &countAllocator);
+    // the arena allocates a few chunks per round for over 200 strings, and keeps one after a reset
+    assert(total - before < 3 * 12 && live == 2);
+    // sizes that would overflow the rounding are refused, and leave the block alone
+    const sdsAllocator *a = sdsArenaAllocator(arena);
+    assert(NULL == a->mallocFn(a->ctx, SIZE_MAX - 4));
+    char *p = a->mallocFn(a->ctx, 3);
+    memcpy(p, "ok", 3);
+    assert(NULL == a->reallocFn(a->ctx, p, SIZE_MAX - 4) && !strcmp("ok", p));
+    sdsArenaFree(arena);
+    assert(0 == live);
+    sdsSetAllocator(NULL);
+    assert(sdsGetAllocator() == &sdsLibcAllocator);
+
+    // the RedisModule allocator, patched back to libc as outside of Redis
+    RMUTil_InitAlloc();
+    sdsUseAllocator(&RMUtil_SDSAllocator);
+    useStrings();
+    sdsUseAllocator(NULL);
+
+    printf("PASS!");
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include <stdio.h>
+#include "search.h"
+#include "assert.h"
+
+int cmp(void *a, void *b) {
+    int *__a = (int *) a;
+    int *__b = (int *) b;
+    return *__a < *__b ? -1 : *__a > *__b;
+}
+
+int main(int argc, char **argv) {
+    // even numbers with some duplicates: 0 2 2 4 6 6 6 8 ...
+    Vector *v = NewVector(int, 0);
+    for (int i = 0; i < 1000; i++) {
+        int x = 2 * i;
+        Vector_Push(v, x);
+        if (i % 3 == 1)
+            Vector_Push(v, x);
+    }
+    size_t n = Vector_Size(v);
+
+    for (int key = -1; key <= 2001; key++) {
+        size_t lb = Vector_LowerBound(v, 0, n, &key, cmp);
+        size_t ub = Vector_UpperBound(v, 0, n, &key, cmp);
+        size_t elb = 0, eub = 0;
+        while (elb < n && *(int *)Vector_GetPtr(v, elb) < key)
+            elb++;
+        while (eub < n && *(int *)Vector_GetPtr(v, eub) <= key)
+            eub++;
+        assert(lb == elb);
+        assert(ub == eub);
+    }
+
+    // sub range and empty range
+    int key = 10;
+    assert(Vector_LowerBound(v, 100, 200, &key, cmp) == 100);
+    assert(Vector_UpperBound(v, 0, 0, &key, cmp) == 0);
+
+    for (size_t size = 0; size < 70; size++) {
+        Vector *w = NewVector(int, size);
+        for (int i = 0; i < size; i++) {
+            int x = 3 * i;
+            Vector_Push(w, x);
+        }
+        EytzingerIndex *ei = NewEytzingerIndex(w, cmp);
+        assert(Eytzinger_Index_Size(ei) == size);
+        for (int key = -1; key <= 3 * (int)size + 1; key++) {
+            int *p = Eytzinger_Index_LowerBound(ei, &key);
+            size_t lb = Vector_LowerBound(w, 0, size, &key, cmp);
+            if (lb == size) {
+                assert(p == NULL);
+            } else {
+                assert(p != NULL && *p == *(int *)Vector_GetPtr(w, lb));
+            }
+            assert(Eytzinger_Index_Contains(ei, &key) == (key >= 0 && key % 3 == 0 && key < 3 * (int)size));
+        }
+        Eytzinger_Index_Free(ei);
+        Vector_Free(w);
+    }
+
+    Vector_Free(v);
+    printf("PASS!");
+    return 0;
+}
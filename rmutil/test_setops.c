@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include "setops.h"
+#include "simd.h"
+#include "assert.h"
+
+/* Fill v with n sorted unique values, each picked with a 1/density chance */
+void fill_sorted(Vector *v, size_t n, int density, int width) {
+    v->top = 0;
+    uint64_t x = 0;
+    while (Vector_Size(v) < n) {
+        x += 1 + rand() % density;
+        if (width == 4) {
+            uint32_t y = x;
+            __vector_PushPtr(v, &y);
+        } else {
+            uint64_t y = x << 20;
+            __vector_PushPtr(v, &y);
+        }
+    }
+}
+
+uint64_t get(Vector *v, size_t i, int width) {
+    void *p = Vector_GetPtr(v, i);
+    return width == 4 ? *(uint32_t *)p : *(uint64_t *)p;
+}
+
+/* Reference merge: op 0 intersect, 1 union, 2 difference */
+void reference(Vector *a, Vector *b, Vector *out, int op, int width) {
+    size_t i = 0, j = 0;
+    out->top = 0;
+    while (i < a->top || j < b->top) {
+        int ina = i < a->top, inb = j < b->top;
+        uint64_t x = ina ? get(a, i, width) : 0, y = inb ? get(b, j, width) : 0;
+        int takeA = ina && (!inb || x <= y), takeB = inb && (!ina || y <= x);
+        int emit = op == 0 ? takeA && takeB : op == 1 ? 1 : takeA && !takeB;
+        if (emit) {
+            __vector_PushPtr(out, takeA ? Vector_GetPtr(a, i) : Vector_GetPtr(b, j));
+        }
+        i += takeA;
+        j += takeB;
+    }
+}
+
+void check(Vector *a, Vector *b, int width) {
+    Vector *out = __newVectorSize(width, 0);
+    Vector *ref = __newVectorSize(width, 0);
+    for (int op = 0; op < 3; op++) {
+        size_t n;
+        if (width == 4) {
+            n = op == 0 ? Vector_IntersectU32(a, b, out) : op == 1 ? Vector_UnionU32(a, b, out)
+                                                                   : Vector_DifferenceU32(a, b, out);
+        } else {
+            n = op == 0 ? Vector_IntersectU64(a, b, out) : op == 1 ? Vector_UnionU64(a, b, out)
+                                                                   : Vector_DifferenceU64(a, b, out);
+        }
+        reference(a, b, ref, op, width);
+        assert(n == Vector_Size(out));
+        assert(n == Vector_Size(ref));
+        assert(!memcmp(out->data, ref->data, n * width));
+    }
+    Vector_Free(out);
+    Vector_Free(ref);
+}
+
+int main(int argc, char **argv) {
+    size_t sizes[][2] = {{0, 0}, {0, 10}, {1, 1}, {3, 5}, {17, 19}, {1000, 1000}, {1000, 1200}, {10, 5000},
+                         {5000, 10}, {4096, 100}};
+    int features[] = {RMUtil_CPUFeatures(), RMUTIL_CPU_SSE2 | RMUTIL_CPU_SSE42, 0};
+
+    for (int width = 4; width <= 8; width += 4) {
+        Vector *a = __newVectorSize(width, 0);
+        Vector *b = __newVectorSize(width, 0);
+        for (int f = 0; f < 3; f++) {
+            RMUtil_SetCPUFeatures(features[f]);
+            for (int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+                for (int density = 1; density <= 8; density *= 2) {
+                    fill_sorted(a, sizes[s][0], density, width);
+                    fill_sorted(b, sizes[s][1], density, width);
+                    check(a, b, width);
+                    check(b, a, width);
+                    check(a, a, width);
+                }
+            }
+        }
+        Vector_Free(a);
+        Vector_Free(b);
+    }
+    RMUtil_SetCPUFeatures(-1);
+
+    printf("PASS!");
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include <stdio.h>
+#include "small_vector.h"
+#include "assert.h"
+
+RMUTIL_SMALL_VECTOR_DECLARE(uint64_t, 4, IdList)
+RMUTIL_SMALL_VECTOR_DECLARE(int, 0, HeapList)
+
+typedef struct {
+    int key;
+    IdList ids;
+} value;
+
+// push [from, to) * 10 to l
+void fill(IdList *l, uint64_t from, uint64_t to) {
+    for (uint64_t i = from; i < to; i++) {
+        IdList_Push(l, i * 10);
+    }
+}
+
+int main(int argc, char **argv) {
+
+    value *val = malloc(sizeof(value));
+    IdList_Init(&val->ids);
+    assert(IdList_Size(&val->ids) == 0);
+    assert(IdList_Cap(&val->ids) == 4);
+
+    for (uint64_t i = 0; i < 4; i++) {
+        assert(IdList_Push(&val->ids, i * 10) == i + 1);
+    }
+    assert(IdList_IsInline(&val->ids));
+    assert(IdList_Data(&val->ids) == val->ids.u.inl);
+
+    // spill to the heap
+    IdList_Push(&val->ids, 40);
+    assert(!IdList_IsInline(&val->ids));
+    assert(IdList_Cap(&val->ids) == 8);
+
+    int N = 1000;
+    fill(&val->ids, 5, N);
+    assert(IdList_Size(&val->ids) == N);
+    for (uint32_t i = 0; i < N; i++) {
+        uint64_t n;
+        assert(IdList_Get(&val->ids, i, &n) == 1);
+        assert(n == i * 10);
+    }
+    assert(IdList_GetPtr(&val->ids, N) == NULL);
+    assert(*IdList_GetPtr(&val->ids, 7) == 70);
+
+    IdList_Clear(&val->ids);
+    assert(IdList_Size(&val->ids) == 0 && IdList_IsInline(&val->ids));
+    assert(IdList_Pop(&val->ids, NULL) == 0);
+
+    free(val);
+
+    uint64_t n;
+    IdList *l = NewIdList();
+    IdList_Push(l, 1);
+    IdList_Push(l, 2);
+    assert(IdList_Get(l, 1, &n) == 1 && n == 2);
+    assert(IdList_Pop(l, &n) == 1 && n == 2);
+    fill(l, 0, 10);
+    assert(IdList_Pop(l, &n) == 1 && n == 90);
+    IdList_Free(l);
+
+    // no inline elements, the first push allocates
+    HeapList h;
+    HeapList_Init(&h);
+    for (int i = 0; i < 100; i++) {
+        assert(HeapList_Push(&h, i) == i + 1);
+    }
+    assert(!HeapList_IsInline(&h) && HeapList_Cap(&h) >= 100);
+    int x;
+    assert(HeapList_Get(&h, 99, &x) == 1 && x == 99);
+    HeapList_Clear(&h);
+
+    printf("PASS!");
+    return 0;
+}
@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "sort.h"
+#include "assert.h"
+
+int cmp(void *a, void *b) {
+    int *__a = (int *) a;
+    int *__b = (int *) b;
+    return *__a < *__b ? -1 : *__a > *__b;
+}
+
+typedef struct {
+    int id;
+    double score;
+} record;
+
+void fill_random(Vector *v, int n, int mod) {
+    v->top = 0;
+    for (int i = 0; i < n; i++) {
+        Vector_Push(v, rand() % mod - mod / 2);
+    }
+}
+
+int is_sorted(Vector *v, size_t first, size_t last) {
+    for (size_t i = first + 1; i < last; i++) {
+        if (cmp(__vector_GetPtr(v, i - 1), __vector_GetPtr(v, i)) > 0)
+            return 0;
+    }
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    int N = 10000;
+    Vector *v = NewVector(int, N);
+
+    // random values, many duplicates, and already sorted input
+    fill_random(v, N, 1000000);
+    Vector_Sort(v, 0, N, cmp);
+    assert(is_sorted(v, 0, N));
+
+    fill_random(v, N, 3);
+    Vector_Sort(v, 0, N, cmp);
+    assert(is_sorted(v, 0, N));
+    Vector_Sort(v, 0, N, cmp);
+    assert(is_sorted(v, 0, N));
+
+    // sub range only
+    fill_random(v, N, 1000);
+    int head;
+    Vector_Get(v, 0, &head);
+    Vector_Sort(v, 1, N - 1, cmp);
+    assert(is_sorted(v, 1, N - 1));
+    int n;
+    Vector_Get(v, 0, &n);
+    assert(n == head);
+
+    // partial sort
+    fill_random(v, N, 1000000);
+    Vector *sorted = NewVector(int, N);
+    Vector_Append(sorted, v);
+    Vector_Sort(sorted, 0, N, cmp);
+    Vector_PartialSort(v, 0, 100, N, cmp);
+    for (int i = 0; i < 100; i++) {
+        int a, b;
+        Vector_Get(v, i, &a);
+        Vector_Get(sorted, i, &b);
+        assert(a == b);
+    }
+
+    // nth element
+    for (int k = 0; k < 20; k++) {
+        fill_random(v, N, 100);
+        sorted->top = 0;
+        Vector_Append(sorted, v);
+        Vector_Sort(sorted, 0, N, cmp);
+        size_t nth = rand() % N;
+        Vector_NthElement(v, 0, nth, N, cmp);
+        int x, y;
+        Vector_Get(v, nth, &x);
+        Vector_Get(sorted, nth, &y);
+        assert(x == y);
+        for (size_t i = 0; i < N; i++) {
+            Vector_Get(v, i, &y);
+            assert(i < nth ? y <= x : y >= x);
+        }
+    }
+
+    // radix sort of int32 keys
+    fill_random(v, N, 2000000);
+    sorted->top = 0;
+    Vector_Append(sorted, v);
+    Vector_Sort(sorted, 0, N, cmp);
+    Vector_RadixSort(v, 0, N, RADIX_KEY_INT32, 0);
+    assert(!memcmp(v->data, sorted->data, N * sizeof(int)));
+    Vector_Free(sorted);
+    Vector_Free(v);
+
+    // radix sort of doubles
+    v = NewVector(double, N);
+    for (int i = 0; i < N; i++) {
+        Vector_Push(v, (rand() - RAND_MAX / 2) / 1000.0);
+    }
+    Vector_Push(v, -0.0);
+    Vector_Push(v, 0.0);
+    Vector_RadixSort(v, 0, Vector_Size(v), RADIX_KEY_DOUBLE, 0);
+    for (int i = 1; i < Vector_Size(v); i++) {
+        double a, b;
+        Vector_Get(v, i - 1, &a);
+        Vector_Get(v, i, &b);
+        assert(a <= b);
+    }
+    Vector_Free(v);
+
+    // radix sort of uint64 keys
+    v = NewVector(uint64_t, N);
+    for (int i = 0; i < N; i++) {
+        Vector_Push(v, ((uint64_t)rand() << 40) ^ rand());
+    }
+    Vector_RadixSort(v, 0, N, RADIX_KEY_UINT64, 0);
+    for (int i = 1; i < N; i++) {
+        uint64_t a, b;
+        Vector_Get(v, i - 1, &a);
+        Vector_Get(v, i, &b);
+        assert(a <= b);
+    }
+    Vector_Free(v);
+
+    // radix sort of records by a double field is stable
+    v = NewVector(record, N);
+    for (int i = 0; i < N; i++) {
+        record r = {.id = i, .score = rand() % 100 - 50};
+        __vector_PushPtr(v, &r);
+    }
+    Vector_RadixSort(v, 0, N, RADIX_KEY_DOUBLE, offsetof(record, score));
+    for (int i = 1; i < N; i++) {
+        record *a = Vector_GetPtr(v, i - 1);
+        record *b = Vector_GetPtr(v, i);
+        assert(a->score < b->score || (a->score == b->score && a->id < b->id));
+    }
+    Vector_Free(v);
+
+    printf("PASS!");
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include <stdio.h>
+#include "assert.h"
+#include "timer_wheel.h"
+
+#define N 2000
+
+/* Model: every timer ever scheduled, with its handle while it is live */
+uint64_t expires[N];
+TimerWheelNode *handles[N];
+int fired[N];
+
+/* Drain all expired timers at now, checking that exactly the live timers due at now fire */
+void tick(TimerWheel *tw, uint64_t now, size_t batch) {
+    TimerWheelEntry out[16];
+    size_t n;
+    do {
+        n = Timer_Wheel_Tick(tw, now, out, batch);
+        assert(n <= batch);
+        for (size_t i = 0; i < n; i++) {
+            size_t id = (size_t)out[i].data;
+            assert(id < N);
+            assert(handles[id] && !fired[id]);
+            assert(out[i].expires == expires[id]);
+            assert(expires[id] <= now);
+            fired[id] = 1;
+            handles[id] = NULL;
+        }
+    } while (n == batch);
+
+    for (size_t id = 0; id < N; id++) {
+        assert(!handles[id] || expires[id] > now);
+    }
+}
+
+uint64_t random_delay() {
+    switch (rand() % 4) {
+    case 0: return rand() % 10;
+    case 1: return rand() % 1000;
+    case 2: return rand() % 100000;
+    default: return ((uint64_t)rand() << 20) + rand();
+    }
+}
+
+int main(int argc, char **argv) {
+    TimerWheel *tw = NewTimerWheel(1000);
+    TimerWheelEntry out[4];
+    assert(0 == Timer_Wheel_Size(tw));
+    assert(0 == Timer_Wheel_Tick(tw, 5000, out, 4));
+
+    // due timers expire on the next tick, even if the clock does not move
+    Timer_Wheel_Schedule(tw, 10, (void *)1);
+    assert(1 == Timer_Wheel_Tick(tw, 0, out, 4));
+    assert(10 == out[0].expires && (void *)1 == out[0].data);
+
+    TimerWheelNode *a = Timer_Wheel_Schedule(tw, 5001, (void *)2);
+    Timer_Wheel_Schedule(tw, 5064, (void *)3);
+    Timer_Wheel_Schedule(tw, 9000, (void *)4);
+    assert(3 == Timer_Wheel_Size(tw));
+    Timer_Wheel_Cancel(tw, a);
+    assert(2 == Timer_Wheel_Size(tw));
+    assert(0 == Timer_Wheel_Tick(tw, 5063, out, 4));
+    assert(1 == Timer_Wheel_Tick(tw, 5064, out, 4));
+    assert((void *)3 == out[0].data);
+    assert(0 == Timer_Wheel_Tick(tw, 8999, out, 4));
+    assert(1 == Timer_Wheel_Tick(tw, UINT64_MAX, out, 4));
+    assert((void *)4 == out[0].data);
+    assert(0 == Timer_Wheel_Size(tw));
+    Timer_Wheel_Free(tw);
+
+    // random schedules, cancels and clock jumps against the model
+    uint64_t now = 123456789;
+    tw = NewTimerWheel(now);
+    size_t scheduled = 0;
+    for (int round = 0; round < 4000; round++) {
+        int op = rand() % 10;
+        if (op < 5 && scheduled < N) {
+            expires[scheduled] = now + random_delay() - (rand() % 8 == 0 ? 5 : 0);
+            handles[scheduled] = Timer_Wheel_Schedule(tw, expires[scheduled], (void *)scheduled);
+            scheduled++;
+        } else if (op < 7 && scheduled > 0) {
+            size_t id = rand() % scheduled;
+            if (handles[id]) {
+                Timer_Wheel_Cancel(tw, handles[id]);
+                handles[id] = NULL;
+            }
+        } else {
+            now += rand() % 3 == 0 ? random_delay() : rand() % 70;
+            tick(tw, now, 1 + rand() % 16);
+        }
+
+        size_t live = 0;
+        for (size_t id = 0; id < scheduled; id++) {
+            live += handles[id] != NULL;
+        }
+        assert(live == Timer_Wheel_Size(tw));
+    }
+
+    // everything left fires eventually
+    tick(tw, UINT64_MAX, 16);
+    assert(0 == Timer_Wheel_Size(tw));
+    Timer_Wheel_Free(tw);
+
+    // freeing a wheel with pending timers releases them
+    tw = NewTimerWheel(0);
+    for (int i = 0; i < 100; i++) {
+        Timer_Wheel_Schedule(tw, i * 1000, NULL);
+    }
+    Timer_Wheel_Free(tw);
+
+    printf("PASS!");
+    return 0;
+}
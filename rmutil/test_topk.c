@@ -0,0 +1,91 @@
+#include <stdio.h>
+#include "assert.h"
+#include "topk.h"
+#include "sort.h"
+
+/* higher scores first */
+int cmp(void *i1, void *i2) {
+    int *__i1 = (int *)i1;
+    int *__i2 = (int *)i2;
+    return *__i2 - *__i1;
+}
+
+int main(int argc, char **argv) {
+    TopK *tk = NewTopK(int, 3, cmp);
+    Vector *out = NewVector(int, 0);
+    int n;
+    assert(0 == TopK_Size(tk));
+    assert(!TopK_Threshold(tk, &n));
+    assert(TopK_IsCandidate(tk, &(int){-100}));
+
+    assert(TopK_Push(tk, 5));
+    assert(TopK_Push(tk, 1));
+    assert(TopK_Push(tk, 3));
+    assert(3 == TopK_Size(tk));
+    assert(TopK_Threshold(tk, &n));
+    assert(1 == n);
+
+    // non-candidates are rejected without changing anything
+    assert(!TopK_IsCandidate(tk, &(int){0}));
+    assert(!TopK_IsCandidate(tk, &(int){1}));
+    assert(!TopK_Push(tk, 0));
+    assert(TopK_IsCandidate(tk, &(int){2}));
+    assert(TopK_Push(tk, 10));
+    assert(3 == TopK_Size(tk));
+    assert(TopK_Threshold(tk, &n));
+    assert(3 == n);
+
+    assert(3 == TopK_Drain(tk, out));
+    assert(0 == TopK_Size(tk));
+    int expected[] = {10, 5, 3};
+    for (int i = 0; i < 3; i++) {
+        Vector_Get(out, i, &n);
+        assert(expected[i] == n);
+    }
+    TopK_Free(tk);
+
+    // k of 0 retains nothing
+    tk = NewTopK(int, 0, cmp);
+    assert(!TopK_IsCandidate(tk, &(int){1}));
+    assert(!TopK_Push(tk, 1));
+    assert(0 == TopK_Drain(tk, out));
+    assert(0 == Vector_Size(out));
+    TopK_Free(tk);
+
+    // random input against a full sort
+    size_t ks[] = {1, 2, 10, 100, 999, 1000, 2000};
+    Vector *all = NewVector(int, 1000);
+    for (int i = 0; i < 1000; i++) {
+        Vector_Push(all, rand() % 500);
+    }
+    Vector_Sort(all, 0, 1000, cmp);
+    for (int t = 0; t < sizeof(ks) / sizeof(ks[0]); t++) {
+        tk = NewTopK(int, ks[t], cmp);
+        srand(1);
+        Vector *in = NewVector(int, 1000);
+        for (int i = 0; i < 1000; i++) {
+            Vector_Push(in, *(int *)Vector_GetPtr(all, rand() % 1000));
+        }
+        Vector *sorted = NewVector(int, 1000);
+        Vector_Append(sorted, in);
+        Vector_Sort(sorted, 0, 1000, cmp);
+
+        Vector_ForEach(in, int, x) {
+            int candidate = TopK_IsCandidate(tk, x);
+            assert(TopK_Push(tk, *x) == candidate);
+        }
+        size_t k = ks[t] < 1000 ? ks[t] : 1000;
+        assert(k == TopK_Drain(tk, out));
+        assert(k == Vector_Size(out));
+        assert(!memcmp(out->data, sorted->data, k * sizeof(int)));
+
+        Vector_Free(in);
+        Vector_Free(sorted);
+        TopK_Free(tk);
+    }
+    Vector_Free(all);
+    Vector_Free(out);
+
+    printf("PASS!");
+    return 0;
+}
@@ -1,7 +1,10 @@
 #include "vector.h"
 #include <stdio.h>
+#include <stdint.h>
 #include "assert.h"
 
+RMUTIL_VECTOR_DECLARE(int64_t, I64Vec)
+
 int main(int argc, char **argv) {
     
     
@@ -53,6 +56,151 @@ int main(int argc, char **argv) {
     assert (rc == 0);
     
     Vector_Free(v);
+
+    // sequential puts should grow geometrically, not one element at a time
+    v = NewVectorFlags(int, 0, VECTOR_NOZERO);
+    N = 100000;
+    int resizes = 0;
+    size_t lastcap = 0;
+    for (int i = 0; i < N; i++) {
+        Vector_Put(v, i, i);
+        if (Vector_Cap(v) != lastcap) {
+            lastcap = Vector_Cap(v);
+            resizes++;
+        }
+    }
+    assert(resizes < 32);
+    assert(Vector_Size(v) == N);
+
+    // gaps exposed by a put past the end are zeroed even without zero fill
+    Vector_Pop(v, NULL);
+    Vector_Put(v, N + 4, 7);
+    for (int i = N - 1; i < N + 4; i++) {
+        int n = -1;
+        assert(Vector_Get(v, i, &n) == 1 && n == 0);
+    }
+
+    assert(Vector_ShrinkToFit(v) == N + 5);
+    assert(Vector_Cap(v) == Vector_Size(v));
+    assert(Vector_Reserve(v, 10) == N + 5);
+    assert(Vector_Reserve(v, 2 * N) == 2 * N);
+    assert(Vector_Size(v) == N + 5);
+    for (int i = 0; i < N - 1; i++) {
+        int n;
+        assert(Vector_Get(v, i, &n) == 1 && n == i);
+    }
+    Vector_Free(v);
+
+    v = NewVector(int, 4);
+    assert(Vector_ShrinkToFit(v) == 0);
+    Vector_Push(v, 3);
+    assert(Vector_Size(v) == 1);
+    Vector_Free(v);
+
+    // bulk operations
+    int arr[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    v = NewVector(int, 0);
+    assert(Vector_PushMany(v, arr, 5) == 5);
+    assert(Vector_Insert(v, 0, arr + 5, 5) == 1);
+    assert(Vector_Insert(v, 11, arr, 1) == 0);
+    // 5 6 7 8 9 0 1 2 3 4
+    int expected[] = {5, 6, 7, 8, 9, 0, 1, 2, 3, 4};
+    for (int i = 0; i < 10; i++) {
+        int n;
+        assert(Vector_Get(v, i, &n) == 1 && n == expected[i]);
+    }
+    assert(Vector_EraseRange(v, 2, 8) == 6);
+    // 5 6 3 4
+    assert(Vector_Size(v) == 4);
+    assert(Vector_EraseRange(v, 3, 100) == 1);
+    assert(Vector_EraseRange(v, 3, 3) == 0);
+    assert(Vector_Insert(v, 1, NULL, 2) == 1);
+    // 5 0 0 6 3
+    int expected2[] = {5, 0, 0, 6, 3};
+    assert(Vector_Size(v) == 5);
+    for (int i = 0; i < 5; i++) {
+        int n;
+        assert(Vector_Get(v, i, &n) == 1 && n == expected2[i]);
+    }
+    assert(Vector_Append(v, v) == 1);
+    assert(Vector_Size(v) == 10);
+    for (int i = 0; i < 5; i++) {
+        int n;
+        assert(Vector_Get(v, i + 5, &n) == 1 && n == expected2[i]);
+    }
+    Vector *cv = NewVector(char, 1);
+    assert(Vector_Append(v, cv) == 0);
+    Vector_Free(cv);
+    Vector_Free(v);
+
+    // inserting elements of the vector itself, while it has to grow
+    v = NewVector(int, 0);
+    Vector_PushMany(v, arr, 5);
+    Vector_ShrinkToFit(v);
+    assert(Vector_Insert(v, 2, (int *)Vector_Data(v) + 1, 3) == 1);
+    assert(Vector_PushMany(v, Vector_Data(v), 2) == 10);
+    // 0 1 1 2 3 2 3 4 0 1
+    int expected3[] = {0, 1, 1, 2, 3, 2, 3, 4, 0, 1};
+    for (int i = 0; i < 10; i++) {
+        int n;
+        assert(Vector_Get(v, i, &n) == 1 && n == expected3[i]);
+    }
+    Vector_Free(v);
+
+    // zero-copy access
+    typedef struct {
+        double score;
+        char payload[56];
+    } record;
+    v = NewVector(record, 8);
+    for (int i = 0; i < 8; i++) {
+        record r = {.score = i};
+        __vector_PushPtr(v, &r);
+    }
+    record *rp = Vector_GetPtr(v, 3);
+    assert(rp != NULL && rp->score == 3);
+    rp->score = 30;
+    assert(Vector_GetPtr(v, 8) == NULL);
+    assert(((record *)Vector_Data(v))[3].score == 30);
+    double sum = 0;
+    int count = 0;
+    Vector_ForEach(v, record, r) {
+        sum += r->score;
+        count++;
+    }
+    assert(count == 8 && sum == 0 + 1 + 2 + 30 + 4 + 5 + 6 + 7);
+    Vector_Free(v);
+
+    // pointer elements
+    char *words[] = {"hello", "world"};
+    v = NewVector(char *, 2);
+    Vector_PushMany(v, words, 2);
+    size_t len = 0;
+    Vector_ForEach(v, char *, s) {
+        len += strlen(*s);
+    }
+    assert(len == 10);
+    Vector_Free(v);
+
+    I64Vec *iv = NewI64Vec(0);
+    N = 1000;
+    for (int i = 0; i < N; i++) {
+        assert(I64Vec_Push(iv, (int64_t)i * 3) == i + 1);
+    }
+    assert(I64Vec_Size(iv) == N);
+    assert(I64Vec_Cap(iv) >= N);
+    I64Vec_Put(iv, N + 9, -1);
+    assert(I64Vec_Size(iv) == N + 10);
+
+    int64_t x;
+    assert(I64Vec_Get(iv, N + 5, &x) == 1 && x == 0);
+    assert(I64Vec_Get(iv, N + 10, &x) == 0);
+    assert(I64Vec_Pop(iv, &x) == 1 && x == -1);
+    for (int i = 0; i < N; i++) {
+        assert(I64Vec_Get(iv, i, &x) == 1);
+        assert(x == (int64_t)i * 3);
+    }
+    I64Vec_Free(iv);
     printf("PASS!");
     
     return 0;
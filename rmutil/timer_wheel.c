@@ -0,0 +1,156 @@
+#include "timer_wheel.h"
+
+#define TIMER_WHEEL_MASK (TIMER_WHEEL_SLOTS - 1)
+
+TimerWheel *NewTimerWheel(uint64_t now) {
+    TimerWheel *tw = calloc(1, sizeof(TimerWheel));
+    tw->now = now;
+    return tw;
+}
+
+inline size_t Timer_Wheel_Size(TimerWheel *tw) {
+    return tw->size;
+}
+
+/* Return the level of a timer expiring at expires, which must be after the current time */
+static inline int __timer_wheel_level(TimerWheel *tw, uint64_t expires) {
+    return (63 - __builtin_clzll(expires ^ tw->now)) / TIMER_WHEEL_BITS;
+}
+
+static inline int __timer_wheel_slot(uint64_t expires, int level) {
+    return (expires >> (level * TIMER_WHEEL_BITS)) & TIMER_WHEEL_MASK;
+}
+
+static inline void __timer_wheel_link(TimerWheelNode **head, TimerWheelNode *node) {
+    node->next = *head;
+    if (node->next)
+        node->next->pprev = &node->next;
+    node->pprev = head;
+    *head = node;
+}
+
+/* Put node in the slot of its deadline, or in the expired list if it is due */
+static void __timer_wheel_insert(TimerWheel *tw, TimerWheelNode *node) {
+    if (node->expires <= tw->now) {
+        __timer_wheel_link(&tw->expired, node);
+        return;
+    }
+    int level = __timer_wheel_level(tw, node->expires);
+    int slot = __timer_wheel_slot(node->expires, level);
+    __timer_wheel_link(&tw->slots[level][slot], node);
+    tw->pending[level] |= 1ULL << slot;
+}
+
+TimerWheelNode *Timer_Wheel_Schedule(TimerWheel *tw, uint64_t expires, void *data) {
+    TimerWheelNode *node = tw->freeNodes;
+    if (node) {
+        tw->freeNodes = node->next;
+    } else {
+        node = malloc(sizeof(TimerWheelNode));
+    }
+    node->expires = expires;
+    node->data = data;
+    __timer_wheel_insert(tw, node);
+    tw->size++;
+    return node;
+}
+
+/* Unlink node from its list and put it on the free list */
+static void __timer_wheel_release(TimerWheel *tw, TimerWheelNode *node) {
+    *node->pprev = node->next;
+    if (node->next)
+        node->next->pprev = node->pprev;
+    node->next = tw->freeNodes;
+    tw->freeNodes = node;
+    tw->size--;
+}
+
+void Timer_Wheel_Cancel(TimerWheel *tw, TimerWheelNode *node) {
+    __timer_wheel_release(tw, node);
+
+    // a timer still in the wheel is in the slot it was put in, since the clock has not reached that slot yet
+    if (node->expires > tw->now) {
+        int level = __timer_wheel_level(tw, node->expires);
+        int slot = __timer_wheel_slot(node->expires, level);
+        if (!tw->slots[level][slot])
+            tw->pending[level] &= ~(1ULL << slot);
+    }
+}
+
+/* Move the clock to now, which must be later than the current time.
+ * The timers of a level all share the bits of the current time above it, and their slot is after the current one.
+ * So when the clock moves, the timers to revisit in each level are those in the slots it moved past or into, or all
+ * of them if it left the range of the level. They either expired, or move to a lower level. Levels above the first
+ * one whose slot did not change are untouched. */
+static void __timer_wheel_advance(TimerWheel *tw, uint64_t now) {
+    TimerWheelNode *todo = NULL;
+
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        int shift = level * TIMER_WHEEL_BITS;
+        uint64_t oldp = tw->now >> shift, newp = now >> shift;
+        if (oldp == newp)
+            break;
+
+        uint64_t reached = ~0ULL;
+        if ((oldp >> TIMER_WHEEL_BITS) == (newp >> TIMER_WHEEL_BITS)) {
+            // slots (old, new]. 2ULL << 63 wraps to 0, which still gives the right mask
+            reached = ((2ULL << (newp & TIMER_WHEEL_MASK)) - 1) & ~((2ULL << (oldp & TIMER_WHEEL_MASK)) - 1);
+        }
+
+        uint64_t slots = tw->pending[level] & reached;
+        tw->pending[level] &= ~reached;
+        while (slots) {
+            int slot = __builtin_ctzll(slots);
+            slots &= slots - 1;
+            TimerWheelNode *node = tw->slots[level][slot];
+            tw->slots[level][slot] = NULL;
+            while (node) {
+                TimerWheelNode *next = node->next;
+                node->next = todo;
+                todo = node;
+                node = next;
+            }
+        }
+    }
+
+    tw->now = now;
+    while (todo) {
+        TimerWheelNode *next = todo->next;
+        __timer_wheel_insert(tw, todo);
+        todo = next;
+    }
+}
+
+size_t Timer_Wheel_Tick(TimerWheel *tw, uint64_t now, TimerWheelEntry *out, size_t max) {
+    if (now > tw->now)
+        __timer_wheel_advance(tw, now);
+
+    size_t n = 0;
+    while (n < max && tw->expired) {
+        TimerWheelNode *node = tw->expired;
+        out[n].expires = node->expires;
+        out[n].data = node->data;
+        n++;
+        __timer_wheel_release(tw, node);
+    }
+    return n;
+}
+
+static void __timer_wheel_free_list(TimerWheelNode *node) {
+    while (node) {
+        TimerWheelNode *next = node->next;
+        free(node);
+        node = next;
+    }
+}
+
+void Timer_Wheel_Free(TimerWheel *tw) {
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        for (int slot = 0; slot < TIMER_WHEEL_SLOTS; slot++) {
+            __timer_wheel_free_list(tw->slots[level][slot]);
+        }
+    }
+    __timer_wheel_free_list(tw->expired);
+    __timer_wheel_free_list(tw->freeNodes);
+    free(tw);
+}
@@ -0,0 +1,78 @@
+#ifndef __TIMER_WHEEL_H__
+#define __TIMER_WHEEL_H__
+
+#include <stdint.h>
+#include <stdlib.h>
+
+/* Hierarchical timing wheel
+ * Keeps timers with millisecond deadlines, as an alternative to a PriorityQueue keyed by deadline. Scheduling and
+ * cancelling a timer are O(1), and advancing the clock costs O(1) per timer per level it moves down, regardless of
+ * how much time passed.
+ * The wheel has TIMER_WHEEL_LEVELS levels of 64 slots. A timer is kept at the level of the highest 6 bit group in
+ * which its deadline differs from the current time, in the slot given by that group of its deadline. When the clock
+ * reaches a slot, its timers are moved down to lower levels, or reported as expired.
+ * Times are absolute milliseconds from any epoch the caller chooses, e.g. RedisModule_Milliseconds().
+ */
+
+#define TIMER_WHEEL_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+// enough levels to cover any 64 bit deadline
+#define TIMER_WHEEL_LEVELS ((64 + TIMER_WHEEL_BITS - 1) / TIMER_WHEEL_BITS)
+
+/* A scheduled timer. It is owned by the wheel, and is only valid until it expires or is cancelled */
+typedef struct timerWheelNode {
+    struct timerWheelNode *next;
+    // the pointer pointing to this node, for O(1) unlinking
+    struct timerWheelNode **pprev;
+    uint64_t expires;
+    void *data;
+} TimerWheelNode;
+
+/* An expired timer, as returned by Timer_Wheel_Tick */
+typedef struct {
+    uint64_t expires;
+    void *data;
+} TimerWheelEntry;
+
+typedef struct {
+    // the current time, timers at or before it have expired
+    uint64_t now;
+    size_t size;
+    // bitmaps of the non-empty slots of each level
+    uint64_t pending[TIMER_WHEEL_LEVELS];
+    TimerWheelNode *slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+    // timers that have expired but were not returned by Timer_Wheel_Tick yet
+    TimerWheelNode *expired;
+    // released nodes, reused by later schedules
+    TimerWheelNode *freeNodes;
+} TimerWheel;
+
+/* Create a new timer wheel whose clock starts at now */
+TimerWheel *NewTimerWheel(uint64_t now);
+
+/* Return the number of timers that were not returned by Timer_Wheel_Tick or cancelled yet */
+size_t Timer_Wheel_Size(TimerWheel *tw);
+
+/* Schedule a timer
+ * Schedules data to expire at the absolute time expires. A deadline that is not after the wheel's current time
+ * expires on the next tick. Returns a handle that can be used to cancel the timer until it expires.
+ */
+TimerWheelNode *Timer_Wheel_Schedule(TimerWheel *tw, uint64_t expires, void *data);
+
+/* Cancel a timer
+ * Removes a timer before it is returned by Timer_Wheel_Tick. The handle is invalid afterwards, and must not be used
+ * after the timer was returned by Timer_Wheel_Tick either.
+ */
+void Timer_Wheel_Cancel(TimerWheel *tw, TimerWheelNode *node);
+
+/* Advance the clock and collect expired timers
+ * Advances the clock of the wheel to now, if it is later than the current time, and copies up to max expired timers
+ * to out. Returns the number of timers copied. If it returns max, there may be more expired timers, which the next
+ * calls return, so call it until it returns less than max. Timers are returned in no particular order.
+ */
+size_t Timer_Wheel_Tick(TimerWheel *tw, uint64_t now, TimerWheelEntry *out, size_t max);
+
+/* free the wheel and all its timers. Does not release their data */
+void Timer_Wheel_Free(TimerWheel *tw);
+
+#endif //__TIMER_WHEEL_H__
@@ -0,0 +1,56 @@
+#include "topk.h"
+#include "heap.h"
+
+TopK *__newTopKSize(size_t elemSize, size_t k, int (*cmp)(void *, void *)) {
+    TopK *tk = malloc(sizeof(TopK));
+    tk->v = __newVectorSizeFlags(elemSize, k, VECTOR_NOZERO);
+    tk->k = k;
+    tk->cmp = cmp;
+    return tk;
+}
+
+inline size_t TopK_Size(TopK *tk) {
+    return tk->v->top;
+}
+
+inline int TopK_IsCandidate(TopK *tk, void *elem) {
+    if (tk->v->top < tk->k)
+        return 1;
+    return tk->k > 0 && tk->cmp(elem, __vector_GetPtr(tk->v, 0)) < 0;
+}
+
+int TopK_Threshold(TopK *tk, void *ptr) {
+    if (tk->k == 0 || tk->v->top < tk->k)
+        return 0;
+    memcpy(ptr, __vector_GetPtr(tk->v, 0), tk->v->elemSize);
+    return 1;
+}
+
+int __topK_PushPtr(TopK *tk, void *elem) {
+    if (tk->v->top < tk->k) {
+        size_t top = __vector_PushPtr(tk->v, elem);
+        Heap_Push(tk->v, 0, top, tk->cmp);
+        return 1;
+    }
+    if (!TopK_IsCandidate(tk, elem))
+        return 0;
+    Heap_ReplaceTop(tk->v, 0, tk->v->top, tk->cmp, elem);
+    return 1;
+}
+
+size_t TopK_Drain(TopK *tk, Vector *out) {
+    // popping the heap in place leaves it sorted in ascending order
+    size_t n = tk->v->top;
+    for (size_t last = n; last > 1; last--) {
+        Heap_Pop(tk->v, 0, last, tk->cmp);
+    }
+    out->top = 0;
+    Vector_Append(out, tk->v);
+    tk->v->top = 0;
+    return n;
+}
+
+void TopK_Free(TopK *tk) {
+    Vector_Free(tk->v);
+    free(tk);
+}
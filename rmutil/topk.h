@@ -0,0 +1,53 @@
+#ifndef __TOPK_H__
+#define __TOPK_H__
+
+#include "vector.h"
+
+/* Bounded top-K
+ * Keeps the k smallest elements pushed into it according to cmp, in O(log k) per push and O(k) memory, like
+ * Vector_PartialSort does for a whole range. To keep the k highest scores, use a cmp that orders higher scores first.
+ * The retained elements are a heap whose top is the worst of them, the one to evict next. Elements that would not
+ * make it in are rejected by a single comparison with it, and elements that do make it in replace it with a single
+ * sift-down.
+ */
+typedef struct {
+    Vector *v;
+    size_t k;
+
+    int (*cmp)(void *, void *);
+} TopK;
+
+/* Construct a top-K holding at most k elements */
+TopK *__newTopKSize(size_t elemSize, size_t k, int (*cmp)(void *, void *));
+
+#define NewTopK(type, k, cmp) __newTopKSize(sizeof(type), k, cmp)
+
+/* Return the number of elements retained, at most k */
+size_t TopK_Size(TopK *tk);
+
+/* Return 1 if elem would be retained if pushed now, without changing anything. Use it to skip building elements
+ * that are not candidates */
+int TopK_IsCandidate(TopK *tk, void *elem);
+
+/* Copy the worst retained element to ptr. Once k elements are retained, anything not better than it is rejected.
+ * Returns 0 if fewer than k elements are retained, since then every element is a candidate */
+int TopK_Threshold(TopK *tk, void *ptr);
+
+/* Offer element
+ * Retains a copy of elem if it is among the k best seen so far, evicting the worst retained element if needed.
+ * Returns 1 if elem was retained.
+ */
+int __topK_PushPtr(TopK *tk, void *elem);
+
+#define TopK_Push(tk, elem) __topK_PushPtr(tk, &(typeof(elem)){elem})
+
+/* Drain in order
+ * Replaces the contents of out with the retained elements, sorted in ascending order of cmp so the best comes
+ * first, and empties tk. out must have the same element type. Returns the number of elements.
+ */
+size_t TopK_Drain(TopK *tk, Vector *out);
+
+/* free the top-K and the underlying data. Does not release its elements if they are pointers */
+void TopK_Free(TopK *tk);
+
+#endif //__TOPK_H__
@@ -8,6 +8,7 @@
 #include <string.h>
 #include <redismodule.h>
 #include "util.h"
+#include "parse.h"
 
 /**
 Check if an argument exists in an argument list (argv,argc), starting at offset.
@@ -155,12 +156,17 @@ int rmutil_vparseArgs(RedisModuleString **argv, int argc, int offset, const char
        } else if (*c == 'l') { //read long
             long long *l = va_arg(ap, long long *);
             
-            if (RedisModule_StringToLongLong(argv[i], l) != REDISMODULE_OK) {
+            // parsed in place, with the same rules as RedisModule_StringToLongLong
+            size_t len;
+            const char *str = RedisModule_StringPtrLen(argv[i], &len);
+            if (!RMUtil_ParseLongLong(str, len, l)) {
                 return REDISMODULE_ERR; 
             }
        } else if (*c == 'd') { //read double
             double *d = va_arg(ap, double *);
-            if (RedisModule_StringToDouble(argv[i], d) != REDISMODULE_OK) {
+            size_t len;
+            const char *str = RedisModule_StringPtrLen(argv[i], &len);
+            if (!RMUtil_ParseDouble(str, len, d)) {
                 return REDISMODULE_ERR;                 
             }
        } else if (*c == '*') { //skip current arg
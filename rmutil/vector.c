@@ -1,15 +1,108 @@
 #include "vector.h"
 #include <stdio.h>
 
+/* Compute the capacity v should grow to in order to hold at least mincap
+ * elements, according to the growth policy */
+static size_t __vector_growCap(Vector *v, size_t mincap) {
+  size_t maxstep = VECTOR_MAX_PREALLOC / v->elemSize;
+  size_t newcap = (size_t)(v->cap * VECTOR_GROWTH_FACTOR);
+
+  if (maxstep == 0) {
+    maxstep = 1;
+  }
+  if (newcap > v->cap + maxstep) {
+    newcap = v->cap + maxstep;
+  }
+  if (newcap <= v->cap) {
+    newcap = v->cap + 1;
+  }
+  return newcap < mincap ? mincap : newcap;
+}
+
 inline int __vector_PushPtr(Vector *v, void *elem) {
   if (v->top == v->cap) {
-    Vector_Resize(v, v->cap ? v->cap * 2 : 1);
+    Vector_Resize(v, __vector_growCap(v, v->top + 1));
   }
 
   __vector_PutPtr(v, v->top, elem);
   return v->top;
 }
 
+/* Make sure v can hold n elements, growing it by the growth policy if not */
+static inline void __vector_ensureCap(Vector *v, size_t n) {
+  if (n > v->cap) {
+    Vector_Resize(v, __vector_growCap(v, n));
+  }
+}
+
+int Vector_PushMany(Vector *v, void *elems, size_t n) {
+  return Vector_Insert(v, v->top, elems, n) ? v->top : 0;
+}
+
+int Vector_Insert(Vector *v, size_t pos, void *elems, size_t n) {
+  if (pos > v->top) {
+    return 0;
+  }
+  if (n == 0) {
+    return 1;
+  }
+  // elems may point into v itself, so keep its offset across the resize
+  size_t size = v->top * v->elemSize;
+  int inside = elems && (char *)elems >= v->data &&
+               (char *)elems < v->data + size;
+  size_t off = inside ? (char *)elems - v->data : 0;
+  __vector_ensureCap(v, v->top + n);
+
+  char *at = v->data + pos * v->elemSize;
+  if (pos < v->top) {
+    memmove(at + n * v->elemSize, at, size - pos * v->elemSize);
+  }
+  if (inside) {
+    // the part of elems before pos stayed in place, the rest moved up by n
+    size_t len = n * v->elemSize, split = pos * v->elemSize;
+    size_t before = off < split ? split - off : 0;
+    if (before > len) {
+      before = len;
+    }
+    memcpy(at, v->data + off, before);
+    memcpy(at + before, v->data + off + before + len, len - before);
+  } else if (elems) {
+    memcpy(at, elems, n * v->elemSize);
+  } else {
+    memset(at, 0, n * v->elemSize);
+  }
+  v->top += n;
+  return 1;
+}
+
+int Vector_EraseRange(Vector *v, size_t first, size_t last) {
+  if (last > v->top) {
+    last = v->top;
+  }
+  if (first >= last) {
+    return 0;
+  }
+  memmove(v->data + first * v->elemSize, v->data + last * v->elemSize,
+          (v->top - last) * v->elemSize);
+  v->top -= last - first;
+  return last - first;
+}
+
+int Vector_Append(Vector *dst, Vector *src) {
+  if (dst->elemSize != src->elemSize) {
+    return 0;
+  }
+  // src may be dst itself, so take the size before resizing
+  size_t n = src->top;
+  if (n == 0) {
+    return 1;
+  }
+  __vector_ensureCap(dst, dst->top + n);
+  memcpy(dst->data + dst->top * dst->elemSize, src->data, n * src->elemSize);
+  dst->top += n;
+  return 1;
+}
+
 inline int Vector_Get(Vector *v, size_t pos, void *ptr) {
   // return 0 if pos is out of bounds
   if (pos >= v->top) {
@@ -35,7 +128,12 @@ inline int Vector_Pop(Vector *v, void *ptr) {
 inline int __vector_PutPtr(Vector *v, size_t pos, void *elem) {
   // resize if pos is out of bounds
   if (pos >= v->cap) {
-    Vector_Resize(v, pos + 1);
+    Vector_Resize(v, __vector_growCap(v, pos + 1));
+  }
+
+  // grown capacity was not zeroed, so zero the gap we are about to expose
+  if ((v->flags & VECTOR_NOZERO) && pos > v->top) {
+    memset(v->data + v->top * v->elemSize, 0, (pos - v->top) * v->elemSize);
   }
 
   if (elem) {
@@ -51,30 +149,62 @@ inline int __vector_PutPtr(Vector *v, size_t pos, void *elem) {
 }
 
 int Vector_Resize(Vector *v, size_t newcap) {
-  int oldcap = v->cap;
+  size_t oldcap = v->cap;
   v->cap = newcap;
 
-  v->data = realloc(v->data, v->cap * v->elemSize);
+  if (newcap == 0) {
+    free(v->data);
+    v->data = NULL;
+  } else {
+    v->data = realloc(v->data, v->cap * v->elemSize);
+  }
 
   // If we grew:
   // put all zeros at the newly realloc'd part of the vector
-  if (newcap > oldcap) {
-    int offset = oldcap * v->elemSize;
+  if (newcap > oldcap && !(v->flags & VECTOR_NOZERO)) {
+    size_t offset = oldcap * v->elemSize;
     memset(v->data + offset, 0, v->cap * v->elemSize - offset);
   }
+  // If we shrank below the used size, drop the elements that were cut off
+  if (v->top > newcap) {
+    v->top = newcap;
+  }
   return v->cap;
 }
 
-Vector *__newVectorSize(size_t elemSize, size_t cap) {
+int Vector_Reserve(Vector *v, size_t n) {
+  if (n > v->cap) {
+    Vector_Resize(v, n);
+  }
+  return v->cap;
+}
+
+int Vector_ShrinkToFit(Vector *v) {
+  if (v->cap > v->top) {
+    Vector_Resize(v, v->top);
+  }
+  return v->cap;
+}
+
+Vector *__newVectorSizeFlags(size_t elemSize, size_t cap, int flags) {
   Vector *vec = malloc(sizeof(Vector));
-  vec->data = calloc(cap, elemSize);
+  if (flags & VECTOR_NOZERO) {
+    vec->data = cap ? malloc(cap * elemSize) : NULL;
+  } else {
+    vec->data = calloc(cap, elemSize);
+  }
   vec->top = 0;
   vec->elemSize = elemSize;
   vec->cap = cap;
+  vec->flags = flags;
 
   return vec;
 }
 
+Vector *__newVectorSize(size_t elemSize, size_t cap) {
+  return __newVectorSizeFlags(elemSize, cap, 0);
+}
+
 void Vector_Free(Vector *v) {
   free(v->data);
   free(v);
@@ -14,13 +14,35 @@ typedef struct {
   size_t elemSize;
   size_t cap;
   size_t top;
-
+  int flags;
 } Vector;
 
+/* Vector creation flags */
+/* Do not zero newly allocated capacity. Only gaps left by putting an element
+ * past the end of the vector are zeroed, when they become part of it */
+#define VECTOR_NOZERO 0x01
+
+/*
+* Growth policy. When a vector runs out of capacity it grows by
+* VECTOR_GROWTH_FACTOR, until a single growth step would exceed
+* VECTOR_MAX_PREALLOC bytes. From then on it grows by VECTOR_MAX_PREALLOC bytes
+* at a time. Both can be overridden at compile time.
+*/
+#ifndef VECTOR_GROWTH_FACTOR
+#define VECTOR_GROWTH_FACTOR 2
+#endif
+
+#ifndef VECTOR_MAX_PREALLOC
+#define VECTOR_MAX_PREALLOC (64 * 1024 * 1024)
+#endif
+
 /* Create a new vector with element size. This should generally be used
  * internall by the NewVector macro */
 Vector *__newVectorSize(size_t elemSize, size_t cap);
 
+/* Same as __newVectorSize, with VECTOR_* creation flags */
+Vector *__newVectorSizeFlags(size_t elemSize, size_t cap, int flags);
+
 // Put a pointer in the vector. To be used internall by the library
 int __vector_PutPtr(Vector *v, size_t pos, void *elem);
 
@@ -30,6 +52,13 @@ int __vector_PutPtr(Vector *v, size_t pos, void *elem);
 */
 #define NewVector(type, cap) __newVectorSize(sizeof(type), cap)
 
+/*
+* Create a new vector with creation flags.
+* e.g. NewVectorFlags(int, 1024, VECTOR_NOZERO)
+*/
+#define NewVectorFlags(type, cap, flags)                                       \
+  __newVectorSizeFlags(sizeof(type), cap, flags)
+
 /*
 * get the element at index pos. The value is copied in to ptr. If pos is outside
 * the vector capacity, we return 0
@@ -40,6 +69,37 @@ int Vector_Get(Vector *v, size_t pos, void *ptr);
 /* Get the element at the end of the vector, decreasing the size by one */
 int Vector_Pop(Vector *v, void *ptr);
 
+/* Get a pointer to the element at pos without bounds checking. To be used
+ * internally by the library */
+static inline char *__vector_GetPtr(Vector *v, size_t pos) {
+  return v->data + (pos * v->elemSize);
+}
+
+/*
+* Get a pointer to the element at index pos, without copying it. If pos is
+* outside the vector size, we return NULL.
+* Note: The pointer is invalidated once the vector is resized
+*/
+static inline void *Vector_GetPtr(Vector *v, size_t pos) {
+  return pos < v->top ? __vector_GetPtr(v, pos) : NULL;
+}
+
+/* Return a pointer to the underlying array of Vector_Size(v) contiguous
+ * elements. Like Vector_GetPtr, it is invalidated once the vector is resized */
+static inline void *Vector_Data(Vector *v) { return v->data; }
+
+/*
+* Iterate the elements of v in place, with var pointing to each element.
+* e.g.
+*   Vector_ForEach(v, struct record, r) {
+*     sum += r->score;
+*   }
+* type may be a pointer type, e.g. Vector_ForEach(v, char *, s) gives a char **s
+*/
+#define Vector_ForEach(v, type, var)                                           \
+  for (typeof(type) *var = (type *)(v)->data, *var##__end = var + (v)->top;    \
+       var < var##__end; var++)
+
 //#define Vector_Getx(v, pos, ptr) pos < v->cap ? 1 : 0; *ptr =
 //*(typeof(ptr))(v->data + v->elemSize*pos)
 
@@ -57,9 +117,40 @@ int Vector_Pop(Vector *v, void *ptr);
 
 int __vector_PushPtr(Vector *v, void *elem);
 
+/* Push n elements from the array elems at the end of v, with a single resize
+ * and copy. If elems is NULL the new elements are zeroed. elems may point into
+ * v itself. Returns the new size of v */
+int Vector_PushMany(Vector *v, void *elems, size_t n);
+
+/*
+* Insert n elements from the array elems before pos, shifting the elements at
+* [pos, size) up by n. If elems is NULL the inserted elements are zeroed.
+* elems may point into v itself, e.g. to duplicate a range of it.
+* Returns 0 if pos is past the end of the vector, 1 otherwise
+*/
+int Vector_Insert(Vector *v, size_t pos, void *elems, size_t n);
+
+/*
+* Erase the elements in the range [first, last), shifting the rest of the
+* vector down. last is clamped to the size of v. Returns the number of elements
+* removed
+*/
+int Vector_EraseRange(Vector *v, size_t first, size_t last);
+
+/* Append all the elements of src at the end of dst. Returns 0 if the vectors
+ * have different element sizes, 1 otherwise */
+int Vector_Append(Vector *dst, Vector *src);
+
 /* resize capacity of v */
 int Vector_Resize(Vector *v, size_t newcap);
 
+/* make sure v has capacity for at least n elements, without changing its size.
+ * Returns the capacity */
+int Vector_Reserve(Vector *v, size_t n);
+
+/* release unused capacity, so that the capacity of v equals its size */
+int Vector_ShrinkToFit(Vector *v);
+
 /* return the used size of the vector, regardless of capacity */
 int Vector_Size(Vector *v);
 
@@ -72,4 +163,98 @@ void Vector_Free(Vector *v);
 
 int __vecotr_PutPtr(Vector *v, size_t pos, void *elem);
 
+/*
+* Declare a typed vector called `name` holding elements of `type`.
+* Since the element type is known at compile time, push/get/put/pop are static
+* inline and compile to plain loads and stores instead of memcpy calls.
+* The generic Vector API above is not affected.
+*
+* e.g.
+*   RMUTIL_VECTOR_DECLARE(int64_t, I64Vec)
+*
+*   I64Vec *v = NewI64Vec(0);
+*   I64Vec_Push(v, 1337);
+*   int64_t x;
+*   I64Vec_Get(v, 0, &x);
+*   I64Vec_Free(v);
+*/
+#define RMUTIL_VECTOR_DECLARE(type, name)                                      \
+  typedef struct {                                                             \
+    type *data;                                                                \
+    size_t cap;                                                                \
+    size_t top;                                                                \
+  } name;                                                                      \
+                                                                               \
+  static inline name *New##name(size_t cap) {                                  \
+    name *v = malloc(sizeof(name));                                            \
+    v->data = calloc(cap, sizeof(type));                                       \
+    v->cap = cap;                                                              \
+    v->top = 0;                                                                \
+    return v;                                                                  \
+  }                                                                            \
+                                                                               \
+  /* resize capacity of v, zeroing the newly grown part */                     \
+  static inline size_t name##_Resize(name *v, size_t newcap) {                 \
+    v->data = realloc(v->data, newcap * sizeof(type));                         \
+    if (newcap > v->cap) {                                                     \
+      memset(v->data + v->cap, 0, (newcap - v->cap) * sizeof(type));          \
+    }                                                                          \
+    v->cap = newcap;                                                           \
+    if (v->top > newcap) {                                                     \
+      v->top = newcap;                                                         \
+    }                                                                          \
+    return v->cap;                                                             \
+  }                                                                            \
+                                                                               \
+  /* push elem at the end of v, return the new size */                         \
+  static inline size_t name##_Push(name *v, type elem) {                       \
+    if (v->top == v->cap) {                                                    \
+      name##_Resize(v, v->cap ? v->cap * 2 : 1);                               \
+    }                                                                          \
+    v->data[v->top++] = elem;                                                  \
+    return v->top;                                                             \
+  }                                                                            \
+                                                                               \
+  /* put elem at pos, growing v if pos is outside its capacity */              \
+  static inline int name##_Put(name *v, size_t pos, type elem) {               \
+    if (pos >= v->cap) {                                                       \
+      name##_Resize(v, pos + 1 > v->cap * 2 ? pos + 1 : v->cap * 2);           \
+    }                                                                          \
+    v->data[pos] = elem;                                                       \
+    if (pos >= v->top) {                                                       \
+      v->top = pos + 1;                                                        \
+    }                                                                          \
+    return 1;                                                                  \
+  }                                                                            \
+                                                                               \
+  /* copy the element at pos to ptr. return 0 if pos is out of bounds */       \
+  static inline int name##_Get(name *v, size_t pos, type *ptr) {               \
+    if (pos >= v->top) {                                                       \
+      return 0;                                                                \
+    }                                                                          \
+    *ptr = v->data[pos];                                                       \
+    return 1;                                                                  \
+  }                                                                            \
+                                                                               \
+  /* remove the last element, copying it to ptr if it is not NULL */           \
+  static inline int name##_Pop(name *v, type *ptr) {                           \
+    if (v->top == 0) {                                                         \
+      return 0;                                                                \
+    }                                                                          \
+    v->top--;                                                                  \
+    if (ptr) {                                                                 \
+      *ptr = v->data[v->top];                                                  \
+    }                                                                          \
+    return 1;                                                                  \
+  }                                                                            \
+                                                                               \
+  static inline size_t name##_Size(name *v) { return v->top; }                 \
+                                                                               \
+  static inline size_t name##_Cap(name *v) { return v->cap; }                  \
+                                                                               \
+  static inline void name##_Free(name *v) {                                    \
+    free(v->data);                                                             \
+    free(v);                                                                   \
+  }
+
 #endif
\ No newline at end of file